@@ -0,0 +1,222 @@
+#ifndef PROJEKT3_BITBOARD_H
+#define PROJEKT3_BITBOARD_H
+
+#include <cstdint>
+#include "Color.h"
+
+// Pole planszy ma indeks x * 8 + y, czyli tak samo jak board[x][y]:
+// bit 0 to a8, bit 7 to h8, bit 56 to a1, bit 63 to h1.
+typedef uint64_t Bitboard;
+
+const Bitboard EMPTY_BB = 0ULL;
+const Bitboard FULL_BB = ~0ULL;
+const Bitboard COLUMN_A_BB = 0x0101010101010101ULL;
+const Bitboard COLUMN_H_BB = COLUMN_A_BB << 7;
+const Bitboard ROW_0_BB = 0xFFULL;
+const Bitboard ROW_7_BB = ROW_0_BB << 56;
+
+inline int squareIndex(int x, int y)
+{
+    return x * 8 + y;
+}
+
+inline int squareRow(int square)
+{
+    return square >> 3;
+}
+
+inline int squareColumn(int square)
+{
+    return square & 7;
+}
+
+inline Bitboard squareBB(int square)
+{
+    return 1ULL << square;
+}
+
+inline Bitboard rowBB(int x)
+{
+    return ROW_0_BB << (8 * x);
+}
+
+inline Bitboard columnBB(int y)
+{
+    return COLUMN_A_BB << y;
+}
+
+inline int popCount(Bitboard b)
+{
+    return __builtin_popcountll(b);
+}
+
+inline int lsb(Bitboard b)
+{
+    return __builtin_ctzll(b);
+}
+
+// Zwraca i usuwa najmłodszy ustawiony bit
+inline int popLsb(Bitboard &b)
+{
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+inline bool moreThanOne(Bitboard b)
+{
+    return (b & (b - 1)) != 0;
+}
+
+// Przesunięcie o jeden wiersz w stronę promocji danego koloru (białe idą do x = 0)
+inline Bitboard pawnPush(Bitboard b, Color color)
+{
+    return color == WHITE ? b >> 8 : b << 8;
+}
+
+inline Bitboard pawnAttacksBB(Bitboard b, Color color)
+{
+    return color == WHITE ? ((b & ~COLUMN_A_BB) >> 9) | ((b & ~COLUMN_H_BB) >> 7)
+                          : ((b & ~COLUMN_A_BB) << 7) | ((b & ~COLUMN_H_BB) << 9);
+}
+
+// Atak figury liniowej wyznaczany promieniami, pole po polu, aż do pierwszej zajętej pozycji.
+// Używany tylko do budowy tablic w Magic.h.
+inline Bitboard slidingAttacks(int square, Bitboard occupied, const int directions[][2], int count)
+{
+    Bitboard attacks = 0;
+    for (int d = 0; d < count; ++d)
+    {
+        int x = squareRow(square) + directions[d][0];
+        int y = squareColumn(square) + directions[d][1];
+        while (x >= 0 && x < 8 && y >= 0 && y < 8)
+        {
+            Bitboard b = squareBB(squareIndex(x, y));
+            attacks |= b;
+            if (occupied & b)
+            {
+                break;
+            }
+            x += directions[d][0];
+            y += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+const int BISHOP_DIRECTIONS[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+const int ROOK_DIRECTIONS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// Tablice ataków skoczka, króla i pionka liczone raz przy pierwszym użyciu
+struct LeaperAttacks
+{
+    Bitboard knight[64];
+    Bitboard king[64];
+    Bitboard pawn[2][64];
+
+    LeaperAttacks()
+    {
+        const int knightSteps[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+        for (int square = 0; square < 64; ++square)
+        {
+            int x = squareRow(square), y = squareColumn(square);
+            knight[square] = 0;
+            king[square] = 0;
+            for (const auto &step: knightSteps)
+            {
+                int nx = x + step[0], ny = y + step[1];
+                if (nx >= 0 && nx < 8 && ny >= 0 && ny < 8)
+                {
+                    knight[square] |= squareBB(squareIndex(nx, ny));
+                }
+            }
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    int nx = x + dx, ny = y + dy;
+                    if ((dx != 0 || dy != 0) && nx >= 0 && nx < 8 && ny >= 0 && ny < 8)
+                    {
+                        king[square] |= squareBB(squareIndex(nx, ny));
+                    }
+                }
+            }
+            pawn[WHITE][square] = pawnAttacksBB(squareBB(square), WHITE);
+            pawn[BLACK][square] = pawnAttacksBB(squareBB(square), BLACK);
+        }
+    }
+};
+
+inline const LeaperAttacks &leaperAttacks()
+{
+    static const LeaperAttacks tables;
+    return tables;
+}
+
+inline Bitboard knightAttacks(int square)
+{
+    return leaperAttacks().knight[square];
+}
+
+inline Bitboard kingAttacks(int square)
+{
+    return leaperAttacks().king[square];
+}
+
+inline Bitboard pawnAttacks(int square, Color color)
+{
+    return leaperAttacks().pawn[color][square];
+}
+
+// Pola pomiędzy dwoma polami na wspólnej linii oraz cała linia przez nie przechodząca
+struct LineTables
+{
+    Bitboard between[64][64];
+    Bitboard line[64][64];
+
+    LineTables()
+    {
+        for (int a = 0; a < 64; ++a)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                between[a][b] = 0;
+                line[a][b] = 0;
+            }
+
+            const int(*directionSets[2])[2] = {BISHOP_DIRECTIONS, ROOK_DIRECTIONS};
+            for (const auto &directions: directionSets)
+            {
+                Bitboard fromA = slidingAttacks(a, 0, directions, 4);
+                for (int b = 0; b < 64; ++b)
+                {
+                    if (fromA & squareBB(b))
+                    {
+                        Bitboard fromB = slidingAttacks(b, 0, directions, 4);
+                        between[a][b] = slidingAttacks(a, squareBB(b), directions, 4) &
+                                        slidingAttacks(b, squareBB(a), directions, 4);
+                        line[a][b] = (fromA & fromB) | squareBB(a) | squareBB(b);
+                    }
+                }
+            }
+        }
+    }
+};
+
+inline const LineTables &lineTables()
+{
+    static const LineTables tables;
+    return tables;
+}
+
+inline Bitboard betweenBB(int a, int b)
+{
+    return lineTables().between[a][b];
+}
+
+inline Bitboard lineBB(int a, int b)
+{
+    return lineTables().line[a][b];
+}
+
+#endif //PROJEKT3_BITBOARD_H
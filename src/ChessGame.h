@@ -2,51 +2,109 @@
 #define PROJEKT3_CHESSGAME_H
 
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <climits>
 #include <vector>
 #include <unordered_map>
 #include <chrono>
 #include <random>
+#include <algorithm>
 #include "Piece.h"
 #include "Move.h"
+#include "PackedMove.h"
+#include "MoveList.h"
+#include "MovePicker.h"
+#include "Reductions.h"
+#include "PruningMargins.h"
+#include "Zobrist.h"
+#include "Magic.h"
 #include "Logger.h"
 #include "GameState.h"
-#include "TranspositionEntry.h"
+#include "TranspositionTable.h"
+#include "PerftTable.h"
+#include "PieceSquareTables.h"
+#include "PawnHashTable.h"
 
 const Piece EMPTY_PIECE = {static_cast<PieceType>(-1), static_cast<Color>(-1)};
 
 class ChessGame
 {
 private:
+    // Pozycja trzymana jest w bitboardach; board[8][8] to tylko widok dla getPiece i GUI,
+    // aktualizowany razem z bitboardami w putPiece/removePiece/movePiece
+    Bitboard pieces[2][6];
+    Bitboard occupied[2];
     Piece board[8][8];
+    uint64_t hashKey; // Klucz Zobrista pozycji, aktualizowany przy każdej zmianie na planszy
+    uint64_t pawnKey; // Klucz Zobrista samych pionków, dla tabeli pionków
+    // Materiał z premiami pozycyjnymi dla środkowej i końcowej gry, dla każdego koloru.
+    // Aktualizowane w putPiece/removePiece, więc ocena nie musi przeglądać planszy.
+    int mgScore[2];
+    int egScore[2];
+    int gamePhase; // Suma PHASE_WEIGHT figur na planszy (może przekroczyć MAX_PHASE po promocji)
     Color currentPlayer;
     bool isCheckmate;
     bool isStalemate;
     bool gameOverState;
-    bool whiteCanCastleKingside;
-    bool whiteCanCastleQueenside;
-    bool blackCanCastleKingside;
-    bool blackCanCastleQueenside;
+    int castlingRights; // Maska praw do roszady (CastlingRight)
     int enPassantTargetX, enPassantTargetY;
+    int halfmoveClock; // Półruchy od ostatniego bicia lub ruchu pionka (reguła 50 ruchów)
     bool isPawnPromotionPending; // Flaga wskazująca na oczekującą promocję
     int promotionX, promotionY; // Współrzędne pola promocji
     PieceType promotionChoice; // Wybrana figura dla promocji
     std::vector<Move> moveHistory;
-    static const int MAX_DEPTH = 10;
+    std::vector<GameState> undoStack; // Rekordy cofania ruchów partii i wyszukiwania
+    static const int DEFAULT_HASH_MB = 16;
+    static const int PAWN_HASH_KB = 512;
+    static const int MAX_PLY = 64;
+    static const int QUIESCENCE_DEPTH = 4;
+    static const int MAX_HISTORY = 16384; // Granica wartości w historyTable
+    static const int ASPIRATION_WINDOW = 50; // Połowa początkowej szerokości okna aspiracji
+    static const int ASPIRATION_MIN_DEPTH = 4;
+    static const int NULL_MOVE_REDUCTION = 2; // Podstawowa redukcja R, rosnąca z głębokością
+    static const int NULL_MOVE_VERIFY_DEPTH = 6; // Od tej głębokości odcięcie po pustym ruchu jest weryfikowane
+    static const int LMR_MIN_DEPTH = 3;
+    static const int LMR_HISTORY_DIVISOR = MAX_HISTORY / 2; // Historia ±MAX_HISTORY zmienia redukcję o ±2
+    static const int MAX_CHECK_EXTENSIONS = 4; // Limit przedłużeń na jednej ścieżce, żeby seria szachów nie
+                                               // wydłużała wyszukiwania bez końca
+    // Największa nominalna głębokość: przedłużenia za szach i quiescenceSearch muszą się jeszcze zmieścić
+    // w MAX_PLY poziomach moveStack i killerMoves
+    static const int MAX_SEARCH_DEPTH = MAX_PLY - MAX_CHECK_EXTENSIONS - QUIESCENCE_DEPTH - 1;
+    static const int NEAR_BEST_MARGIN = 20; // Ruchy najwyżej o tyle gorsze od najlepszego biorą udział w losowaniu
+    static const int INFINITE_SCORE = INT_MAX / 2; // Większe od każdej oceny, a przy tym bezpieczne przy negacji
     Logger logger;
-    std::unordered_map<std::string, Move> openingBook; // Księga debiutów
+    std::unordered_map<uint64_t, Move> openingBook; // Księga debiutów (klucz Zobrista pozycji)
     std::unordered_map<std::string, int> moveRepetitionCount; // Licznik powtórek ruchów
     std::mt19937 rng; // Generator losowy dla losowości ruchów
-    std::unordered_map<std::string, TranspositionEntry> transpositionTable;
-
-    // Killer moves (po dwa na każdą głębokość)
-    std::vector<std::vector<Move>> killerMoves;
+    TranspositionTable transpositionTable;
+    int hashSizeMB;
+    PawnHashTable pawnTable;
+
+    // Listy ruchów dla kolejnych poziomów wyszukiwania, przydzielone raz w konstruktorze.
+    // searchPly to liczba ruchów tymczasowych wykonanych od korzenia.
+    std::vector<MoveList> moveStack;
+    int searchPly;
+
+    // Limit czasu wyszukiwania
+    std::chrono::steady_clock::time_point searchDeadline;
+    uint64_t searchNodes;
+    bool searchStopped;
+    bool nullMoveVerification; // W poddrzewie wyszukiwania weryfikującego pusty ruch nie jest używany
+    int checkExtensions; // Liczba przedłużeń za szach na bieżącej ścieżce od korzenia
+    PruningMargins pruningMargins;
+
+    // Heurystyki uczące się na odcięciach, dla sortowania ruchów cichych: killer moves (po dwa na każdy ply),
+    // historia [kolor][skąd][dokąd] oraz odpowiedź na ruch przeciwnika [skąd][dokąd]
+    PackedMove killerMoves[MAX_PLY][2];
+    int historyTable[2][64][64];
+    PackedMove counterMoves[64][64];
 
     const int CHECK_BONUS = 400;
     const int CHECKMATE_BONUS = 999999;
     const int PROMOTION_BONUS = 1500; // Promote as soon as possible
     const int REPETITION_PENALTY = 8000; // Heavier than before
-    const int THREAT_KING_BONUS = 400; // Nearby attackers
-    const int SAFE_CAPTURE_BONUS = 5000; // Safe capture
+    const int THREAT_KING_BONUS = 400; // Attacks on all squares around the enemy king
     const int KING_SAFETY_BONUS = 200; // King safety
 
     const int PAWN_WEIGHT = 100;
@@ -57,148 +115,180 @@ private:
     const int KING_WEIGHT = 5000;
 
     const int CAPTURE_BONUS_MULTIPLIER = 100;
+    const int DELTA_MARGIN = 200; // Zapas na zmianę oceny pozycyjnej po biciu w quiescenceSearch
+
+    Piece pieceOn(int square) const
+    {
+        return board[squareRow(square)][squareColumn(square)];
+    }
+
+    void putPiece(int square, const Piece &piece)
+    {
+        const PieceSquareTable &table = pieceSquareTable();
+        gamePhase += PHASE_WEIGHT[piece.type];
+        mgScore[piece.color] += table.mg[piece.color][piece.type][square];
+        egScore[piece.color] += table.eg[piece.color][piece.type][square];
+        hashKey ^= zobrist().piece[piece.color][piece.type][square];
+        if (piece.type == PAWN)
+        {
+            pawnKey ^= zobrist().piece[piece.color][PAWN][square];
+        }
+        pieces[piece.color][piece.type] |= squareBB(square);
+        occupied[piece.color] |= squareBB(square);
+        board[squareRow(square)][squareColumn(square)] = piece;
+    }
+
+    void removePiece(int square)
+    {
+        Piece &piece = board[squareRow(square)][squareColumn(square)];
+        const PieceSquareTable &table = pieceSquareTable();
+        gamePhase -= PHASE_WEIGHT[piece.type];
+        mgScore[piece.color] -= table.mg[piece.color][piece.type][square];
+        egScore[piece.color] -= table.eg[piece.color][piece.type][square];
+        hashKey ^= zobrist().piece[piece.color][piece.type][square];
+        if (piece.type == PAWN)
+        {
+            pawnKey ^= zobrist().piece[piece.color][PAWN][square];
+        }
+        pieces[piece.color][piece.type] &= ~squareBB(square);
+        occupied[piece.color] &= ~squareBB(square);
+        piece = EMPTY_PIECE;
+    }
+
+    void replacePiece(int square, const Piece &piece)
+    {
+        removePiece(square);
+        putPiece(square, piece);
+    }
+
+    void movePiece(int from, int to)
+    {
+        Piece piece = pieceOn(from);
+        removePiece(from);
+        putPiece(to, piece);
+    }
 
-    int materialSum()
+    // Prawa do roszady zachowane po ruchu z danego pola lub na nie: ruch króla albo wieży z pola wyjściowego
+    // i zbicie wieży na jej polu wyjściowym odbierają odpowiednie prawa
+    static int castlingRightsKept(int square)
     {
-        int sum = 0;
-        for (int i = 0; i < 8; ++i)
+        static const struct CastlingMasks
         {
-            for (int j = 0; j < 8; ++j)
+            int kept[64];
+
+            CastlingMasks()
             {
-                Piece p = board[i][j];
-                int v = 0;
-                switch (p.type)
+                for (int &mask: kept)
                 {
-                    case PAWN:
-                        v = PAWN_WEIGHT;
-                        break;
-                    case KNIGHT:
-                        v = KNIGHT_WEIGHT;
-                        break;
-                    case BISHOP:
-                        v = BISHOP_WEIGHT;
-                        break;
-                    case ROOK:
-                        v = ROOK_WEIGHT;
-                        break;
-                    case QUEEN:
-                        v = QUEEN_WEIGHT;
-                        break;
-                    default:
-                        v = 0;
+                    mask = ALL_CASTLING;
                 }
-                if (p != EMPTY_PIECE)
+                kept[squareIndex(7, 4)] &= ~WHITE_CASTLING;
+                kept[squareIndex(7, 0)] &= ~WHITE_QUEENSIDE;
+                kept[squareIndex(7, 7)] &= ~WHITE_KINGSIDE;
+                kept[squareIndex(0, 4)] &= ~BLACK_CASTLING;
+                kept[squareIndex(0, 0)] &= ~BLACK_QUEENSIDE;
+                kept[squareIndex(0, 7)] &= ~BLACK_KINGSIDE;
+            }
+        } masks;
+        return masks.kept[square];
+    }
+
+    // Część klucza zależna od praw do roszady i kolumny bicia w przelocie
+    uint64_t stateKey() const
+    {
+        uint64_t key = zobrist().castling[castlingRights];
+        if (enPassantTargetX != -1)
+        {
+            key ^= zobrist().enPassant[enPassantTargetY];
+        }
+        return key;
+    }
+
+    // Klucz liczony od zera; przy ruchach klucz jest tylko aktualizowany
+    uint64_t computeHashKey() const
+    {
+        uint64_t key = stateKey() ^ (currentPlayer == BLACK ? zobrist().side : 0);
+        for (int color = WHITE; color <= BLACK; ++color)
+        {
+            for (int type = PAWN; type <= KING; ++type)
+            {
+                Bitboard b = pieces[color][type];
+                while (b)
                 {
-                    sum += (p.color == currentPlayer ? v : -v);
+                    key ^= zobrist().piece[color][type][popLsb(b)];
                 }
             }
         }
-        return sum;
+        return key;
+    }
+
+    // Pola atakowane przez figurę stojącą na danym polu
+    Bitboard attacksFrom(const Piece &piece, int square, Bitboard occupancy) const
+    {
+        switch (piece.type)
+        {
+            case PAWN:
+                return pawnAttacks(square, piece.color);
+            case KNIGHT:
+                return knightAttacks(square);
+            case BISHOP:
+                return bishopAttacks(square, occupancy);
+            case ROOK:
+                return rookAttacks(square, occupancy);
+            case QUEEN:
+                return queenAttacks(square, occupancy);
+            case KING:
+                return kingAttacks(square);
+            default:
+                return 0;
+        }
+    }
+
+    // Wszystkie figury (obu kolorów) atakujące dane pole
+    Bitboard attackersTo(int square, Bitboard occupancy) const
+    {
+        return (pawnAttacks(square, BLACK) & pieces[WHITE][PAWN]) |
+               (pawnAttacks(square, WHITE) & pieces[BLACK][PAWN]) |
+               (knightAttacks(square) & (pieces[WHITE][KNIGHT] | pieces[BLACK][KNIGHT])) |
+               (kingAttacks(square) & (pieces[WHITE][KING] | pieces[BLACK][KING])) |
+               (bishopAttacks(square, occupancy) & (pieces[WHITE][BISHOP] | pieces[BLACK][BISHOP] |
+                                                    pieces[WHITE][QUEEN] | pieces[BLACK][QUEEN])) |
+               (rookAttacks(square, occupancy) & (pieces[WHITE][ROOK] | pieces[BLACK][ROOK] |
+                                                  pieces[WHITE][QUEEN] | pieces[BLACK][QUEEN]));
+    }
+
+    bool isSquareAttacked(int square, Color byColor) const
+    {
+        return (attackersTo(square, occupied[WHITE] | occupied[BLACK]) & occupied[byColor]) != 0;
     }
 
     // Inicjalizacja księgi debiutów
     void initializeOpeningBook()
     {
         // Proste debiuty, np. 1. e4 e5, 1. d4 d5
-        openingBook["rnbqkbnr/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKBNR w KQkq - 0 1"] = Move(6, 4, 4, 4, "e4"); // 1. e4
-        openingBook["rnbqkbnr/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKBNR w KQkq e6 0 1"] = Move(6, 3, 4, 3,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKBNR w KQkq - 0 1")] = Move(6, 4, 4, 4, "e4"); // 1. e4
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKBNR w KQkq e6 0 1")] = Move(6, 3, 4, 3,
                                                                                                 "d4"); // 1. e4 e5 2. d4
-        openingBook["rnbqkbnr/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKBNR b KQkq - 0 1"] = Move(1, 4, 3, 4,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKBNR b KQkq - 0 1")] = Move(1, 4, 3, 4,
                                                                                            "e5"); // 1. e4 e5
-        openingBook["rnbqkbnr/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKBNR b KQkq - 0 1"] = Move(1, 3, 3, 3,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKBNR b KQkq - 0 1")] = Move(1, 3, 3, 3,
                                                                                                "d5"); // 1. e4 e5 2. d4 d5
 
         // Additional openings
-        openingBook["rnbqkbnr/pppp1ppp/5n2/5p2/4P3/5N2/PPPP1PPP/RNBQKBNR b KQkq - 0 1"] = Move(1, 5, 3, 5,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppp1ppp/5n2/5p2/4P3/5N2/PPPP1PPP/RNBQKBNR b KQkq - 0 1")] = Move(1, 5, 3, 5,
                                                                                                "f5"); // 1. e4 f5 (Dutch Defense)
-        openingBook["rnbqkb1r/pppp1ppp/5n2/5p2/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 1 2"] = Move(6, 5, 4, 5,
+        openingBook[zobristKeyFromFen("rnbqkb1r/pppp1ppp/5n2/5p2/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 1 2")] = Move(6, 5, 4, 5,
                                                                                                "f3"); // 1. e4 f5 2. f3
-        openingBook["rnbqkbnr/pppppppp/8/8/4P3/8/PPPPPPPP/RNBQKBNR b KQkq e3 0 1"] = Move(6, 2, 4, 2,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPPPPPP/RNBQKBNR b KQkq e3 0 1")] = Move(6, 2, 4, 2,
                                                                                           "c4"); // 1. e4 c4 (unorthodox)
-        openingBook["rnbqkb1r/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2"] = Move(1, 2, 3, 2,
+        openingBook[zobristKeyFromFen("rnbqkb1r/pppp1ppp/5n2/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2")] = Move(1, 2, 3, 2,
                                                                                                "c5"); // 1. e4 e5 2. Nf3 c5 (Sicilian Defense)
-        openingBook["rnbqkb1r/pp1ppppp/5n2/2p5/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq c6 0 2"] = Move(6, 3, 4, 3,
+        openingBook[zobristKeyFromFen("rnbqkb1r/pp1ppppp/5n2/2p5/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq c6 0 2")] = Move(6, 3, 4, 3,
                                                                                                 "d4"); // 1. e4 c5 2. d4
-        openingBook["rnbqkbnr/pp1ppppp/5n2/5p2/4P3/8/PPPPPPPP/RNBQKBNR w KQkq - 0 2"] = Move(6, 5, 4, 5,
+        openingBook[zobristKeyFromFen("rnbqkbnr/pp1ppppp/5n2/5p2/4P3/8/PPPPPPPP/RNBQKBNR w KQkq - 0 2")] = Move(6, 5, 4, 5,
                                                                                              "f4"); // 1. e4 f5 2. f4 (From's Gambit)
     }
 
-    // Generowanie klucza pozycji dla tabeli transpozycji
-    std::string getPositionKey() const
-    {
-        std::string key;
-        int emptyCount = 0;
-
-        // Generowanie układu figur (8 rzędów)
-        for (int i = 0; i < 8; ++i)
-        {
-            for (int j = 0; j < 8; ++j)
-            {
-                Piece p = board[i][j];
-                if (p == EMPTY_PIECE)
-                {
-                    emptyCount++;
-                }
-                else
-                {
-                    if (emptyCount > 0)
-                    {
-                        key += std::to_string(emptyCount);
-                        emptyCount = 0;
-                    }
-                    key += p.color == WHITE ? toupper(pieceToChar(p.type)) : tolower(pieceToChar(p.type));
-                }
-            }
-            if (emptyCount > 0)
-            {
-                key += std::to_string(emptyCount);
-                emptyCount = 0;
-            }
-            if (i < 7)
-            {
-                key += "/";
-            }
-        }
-
-        // Kolor, który ma ruch
-        key += std::string(" ") + (currentPlayer == WHITE ? "w" : "b");
-
-        // Prawa do roszady
-        std::string castling = "";
-        if (whiteCanCastleKingside)
-        {
-            castling += "K";
-        }
-        if (whiteCanCastleQueenside)
-        {
-            castling += "Q";
-        }
-        if (blackCanCastleKingside)
-        {
-            castling += "k";
-        }
-        if (blackCanCastleQueenside)
-        {
-            castling += "q";
-        }
-        key += " " + (castling.empty() ? "-" : castling);
-
-        // Pole en passant
-        if (enPassantTargetX != -1 && enPassantTargetY != -1)
-        {
-            key += " " + std::string(1, 'a' + enPassantTargetY) + std::to_string(8 - enPassantTargetX);
-        }
-        else
-        {
-            key += " -";
-        }
-
-        // Liczba posunięć (uproszczone, można pominąć)
-        key += " 0 1";
-
-        return key;
-    }
-
     char pieceToChar(PieceType type) const
     {
         switch (type)
@@ -220,15 +310,9 @@ private:
         }
     }
 
-    // Funkcja do obliczania wartości zdobytej figury dla sortowania ruchów
-    int getCaptureValue(const Move &move) const
+    int getPieceValue(PieceType type) const
     {
-        Piece target = board[move.toX][move.toY];
-        if (target == EMPTY_PIECE)
-        {
-            return 0;
-        }
-        switch (target.type)
+        switch (type)
         {
             case PAWN:
                 return PAWN_WEIGHT;
@@ -247,6 +331,104 @@ private:
         }
     }
 
+    // Funkcja do obliczania wartości zdobytej figury dla sortowania ruchów
+    int getCaptureValue(const PackedMove &move) const
+    {
+        Piece target = pieceOn(move.to());
+        if (target == EMPTY_PIECE)
+        {
+            return 0;
+        }
+        return getPieceValue(target.type);
+    }
+
+    bool isCapture(const PackedMove &move) const
+    {
+        return pieceOn(move.to()) != EMPTY_PIECE || move.flag() == EN_PASSANT_MOVE;
+    }
+
+    // Zysk materiału z bicia lub promocji, bez odpowiedzi przeciwnika
+    int materialGain(const PackedMove &move) const
+    {
+        int gain = move.flag() == EN_PASSANT_MOVE ? PAWN_WEIGHT : getCaptureValue(move);
+        if (move.flag() == PROMOTION_MOVE)
+        {
+            gain += getPieceValue(move.promotion()) - PAWN_WEIGHT;
+        }
+        return gain;
+    }
+
+    // MVV-LVA: najcenniejsza bita figura, a przy równej - najtańsza bijąca
+    int mvvLva(const PackedMove &move) const
+    {
+        return materialGain(move) * CAPTURE_BONUS_MULTIPLIER - pieceOn(move.from()).type;
+    }
+
+    // Statyczna ocena wymiany (SEE) na polu docelowym: obie strony biją na zmianę najtańszą figurą i mogą
+    // przerwać wymianę, gdy dalsze bicie się nie opłaca. Po każdym biciu atakujący liczeni są od nowa, więc
+    // figury stojące za zabraną (np. wieże zdublowane na linii) włączają się do wymiany. Związania są pomijane.
+    int see(const PackedMove &move) const
+    {
+        if (move.flag() == CASTLING_MOVE)
+        {
+            return 0;
+        }
+
+        int from = move.from();
+        int to = move.to();
+        Bitboard occupancy = (occupied[WHITE] | occupied[BLACK]) ^ squareBB(from);
+        int gain[32];
+        gain[0] = getCaptureValue(move);
+        if (move.flag() == EN_PASSANT_MOVE)
+        {
+            gain[0] = PAWN_WEIGHT;
+            occupancy ^= squareBB(squareIndex(squareRow(from), squareColumn(to)));
+        }
+
+        Piece attacker = pieceOn(from);
+        Color side = attacker.color;
+        int attackerValue = getPieceValue(attacker.type);
+        // Po promocji na polu stoi już nowa figura
+        if (move.flag() == PROMOTION_MOVE)
+        {
+            gain[0] += getPieceValue(move.promotion()) - PAWN_WEIGHT;
+            attackerValue = getPieceValue(move.promotion());
+        }
+        Bitboard attackers = attackersTo(to, occupancy) & occupancy;
+        int depth = 0;
+        while (depth < 31)
+        {
+            side = side == WHITE ? BLACK : WHITE;
+            Bitboard own = attackers & occupied[side];
+            if (own == 0)
+            {
+                break;
+            }
+            int type = PAWN;
+            while ((own & pieces[side][type]) == 0)
+            {
+                ++type;
+            }
+            // Król nie może bić na pole, którego przeciwnik nadal broni
+            if (type == KING && (attackers & occupied[side == WHITE ? BLACK : WHITE]))
+            {
+                break;
+            }
+
+            ++depth;
+            gain[depth] = attackerValue - gain[depth - 1];
+            occupancy ^= squareBB(lsb(own & pieces[side][type]));
+            attackers = attackersTo(to, occupancy) & occupancy;
+            attackerValue = getPieceValue(static_cast<PieceType>(type));
+        }
+        while (depth > 0)
+        {
+            --depth;
+            gain[depth] = -std::max(-gain[depth], gain[depth + 1]);
+        }
+        return gain[0];
+    }
+
     std::string generateAlgebraicNotation(const Move &move, const GameState &state)
     {
         Piece piece = state.movedPiece;
@@ -257,7 +439,6 @@ private:
 
         std::string notation;
         std::string pieceSymbol;
-        sf::String str;
         switch (piece.type)
         {
             case KNIGHT:
@@ -311,99 +492,32 @@ private:
         notation += char('a' + move.toY);
         notation += std::to_string(8 - move.toX);
 
-        bool isPromotion = (piece.type == PAWN && (move.toX == 0 || move.toX == 7));
-        std::string promotionNotation;
-        if (isPromotion)
-        {
-            promotionNotation += "=";
-            pieceSymbol = "";
-            switch (board[move.toX][move.toY].type)
-            {
-                case QUEEN:
-                    pieceSymbol = "Q";
-                    break;
-                case ROOK:
-                    pieceSymbol = "R";
-                    break;
-                case BISHOP:
-                    pieceSymbol = "B";
-                    break;
-                case KNIGHT:
-                    pieceSymbol = "N";
-                    break;
-                default:
-                    break;
-            }
-
-            if (board[move.toX][move.toY].color == BLACK)
-            {
-                pieceSymbol[0] = tolower(pieceSymbol[0]);
-            }
-
-            promotionNotation += pieceSymbol;
-        }
-
-        // Sprawdzenie szacha/mata bez modyfikacji historii
-        Piece tempTo = board[move.toX][move.toY];
-        Piece tempFrom = board[move.fromX][move.fromY];
-        board[move.toX][move.toY] = tempFrom;
-        board[move.fromX][move.fromY] = EMPTY_PIECE;
-        bool isCheck = isInCheck(currentPlayer == WHITE ? BLACK : WHITE);
-        bool isMate = isCheck && getAllPossibleMoves(currentPlayer == WHITE ? BLACK : WHITE).empty();
-        board[move.fromX][move.fromY] = tempFrom;
-        board[move.toX][move.toY] = tempTo;
+        // Sprawdzenie szacha/mata - ruch jest już wykonany, a currentPlayer to strona, która odpowiada
+        bool isCheck = isInCheck(currentPlayer);
+        bool isMate = isCheck && getAllPossibleMoves(currentPlayer).empty();
 
         if (isCheck)
         {
             notation += isMate ? "#" : "+";
         }
 
-        return notation + promotionNotation;
-    }
-
-    int getBestPromotionEval(const Move &move, int depth, int alpha, int beta, bool maximizingPlayer)
-    {
-        int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
-        PieceType options[] = {QUEEN, ROOK, BISHOP, KNIGHT};
-        for (PieceType option: options)
-        {
-            board[move.toX][move.toY] = Piece(option, board[move.toX][move.toY].color);
-            int eval = minimax(depth, alpha, beta, !maximizingPlayer);
-            if (maximizingPlayer && eval > bestEval)
-            {
-                bestEval = eval;
-            }
-            else if (!maximizingPlayer && eval < bestEval)
-            {
-                bestEval = eval;
-            }
-            if (maximizingPlayer)
-            {
-                alpha = std::max(alpha, eval);
-            }
-            else
-            {
-                beta = std::min(beta, eval);
-            }
-            if (beta <= alpha)
-            {
-                break;
-            }
-        }
-        board[move.toX][move.toY] = Piece(options[0], board[move.toX][move.toY].color); // Przywróć domyślną promocję
-        return bestEval;
+        return notation;
     }
 
 public:
-    ChessGame() : currentPlayer(WHITE), isCheckmate(false), isStalemate(false), gameOverState(false),
-                  whiteCanCastleKingside(true), whiteCanCastleQueenside(true), blackCanCastleKingside(true),
-                  blackCanCastleQueenside(true), enPassantTargetX(-1), enPassantTargetY(-1),
+    ChessGame() : hashKey(0), pawnKey(0), currentPlayer(WHITE), isCheckmate(false), isStalemate(false), gameOverState(false),
+                  castlingRights(ALL_CASTLING), enPassantTargetX(-1), enPassantTargetY(-1), halfmoveClock(0),
                   isPawnPromotionPending(false), promotionX(-1), promotionY(-1), promotionChoice(QUEEN),
-                  logger("chess_log.txt")
+                  logger("chess_log.txt"), transpositionTable(DEFAULT_HASH_MB), hashSizeMB(DEFAULT_HASH_MB),
+                  pawnTable(PAWN_HASH_KB), moveStack(MAX_PLY), searchPly(0), searchNodes(0), searchStopped(false),
+                  nullMoveVerification(false), checkExtensions(0)
     {
+        sliderAttacks(); // Tablice ataków budujemy przy starcie, a nie przy pierwszym ruchu
+        undoStack.reserve(1024); // Zapas na całą partię, bez przydziałów pamięci w czasie wyszukiwania
         initializeBoard();
+        hashKey = computeHashKey();
         initializeOpeningBook();
-        killerMoves.resize(MAX_DEPTH + 1, std::vector<Move>(2, Move(-1, -1, -1, -1)));
+        clearMoveOrdering();
     }
 
     PieceType getPromotionChoice() const
@@ -416,6 +530,23 @@ public:
         promotionChoice = type;
     }
 
+    // Rozmiar tabeli transpozycji w MB (zaokrąglany w dół do potęgi dwójki)
+    void setHashSize(int megabytes)
+    {
+        hashSizeMB = megabytes;
+        transpositionTable.resize(hashSizeMB);
+    }
+
+    const PruningMargins &getPruningMargins() const
+    {
+        return pruningMargins;
+    }
+
+    void setPruningMargins(const PruningMargins &margins)
+    {
+        pruningMargins = margins;
+    }
+
     int getEnPassantTargetX()
     {
         return enPassantTargetX;
@@ -426,33 +557,40 @@ public:
         return enPassantTargetY;
     };
 
-    void initializeBoard()
+    void clearBoard()
     {
-        for (int i = 2; i <= 5; i++)
+        gamePhase = 0;
+        pawnKey = 0;
+        for (int c = 0; c < 2; ++c)
+        {
+            occupied[c] = 0;
+            mgScore[c] = 0;
+            egScore[c] = 0;
+            for (int type = PAWN; type <= KING; ++type)
+            {
+                pieces[c][type] = 0;
+            }
+        }
+        for (int i = 0; i < 8; i++)
         {
             for (int j = 0; j < 8; j++)
             {
                 board[i][j] = EMPTY_PIECE;
             }
         }
+    }
 
+    void initializeBoard()
+    {
+        clearBoard();
+        const PieceType backRank[8] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
         for (int i = 0; i < 8; i++)
         {
-            board[1][i] = Piece(PAWN, BLACK);
-            board[6][i] = Piece(PAWN, WHITE);
+            putPiece(squareIndex(0, i), Piece(backRank[i], BLACK));
+            putPiece(squareIndex(1, i), Piece(PAWN, BLACK));
+            putPiece(squareIndex(6, i), Piece(PAWN, WHITE));
+            putPiece(squareIndex(7, i), Piece(backRank[i], WHITE));
         }
-
-        board[0][0] = board[0][7] = Piece(ROOK, BLACK);
-        board[0][1] = board[0][6] = Piece(KNIGHT, BLACK);
-        board[0][2] = board[0][5] = Piece(BISHOP, BLACK);
-        board[0][3] = Piece(QUEEN, BLACK);
-        board[0][4] = Piece(KING, BLACK);
-
-        board[7][0] = board[7][7] = Piece(ROOK, WHITE);
-        board[7][1] = board[7][6] = Piece(KNIGHT, WHITE);
-        board[7][2] = board[7][5] = Piece(BISHOP, WHITE);
-        board[7][3] = Piece(QUEEN, WHITE);
-        board[7][4] = Piece(KING, WHITE);
     }
 
     Piece getPiece(int x, int y) const
@@ -472,566 +610,391 @@ public:
 
     bool isInCheck(Color color) // const
     {
-        int kingX = -1, kingY = -1;
-        bool kingFound = false;
-        for (int i = 0; i < 8; ++i)
-        {
-            for (int j = 0; j < 8; ++j)
-            {
-                if (board[i][j] != EMPTY_PIECE && board[i][j].type == KING && board[i][j].color == color)
-                {
-                    kingX = i;
-                    kingY = j;
-                    kingFound = true;
-                    break;
-                }
-            }
-        }
-
-        if (!kingFound)
+        if (pieces[color][KING] == 0)
         {
             logger.log("King not found for color " + std::to_string(color) + "! Assuming checkmate.", Logger::ERROR);
             return true; // Brak króla = automatyczny mat
         }
 
         Color opponent = (color == WHITE) ? BLACK : WHITE;
-        for (int x = 0; x < 8; ++x)
+        return isSquareAttacked(lsb(pieces[color][KING]), opponent);
+    }
+
+    // Ruch legalny o podanych polach (dla promocji pierwszy z czterech wariantów) albo pusty ruch
+    PackedMove findLegalMove(const Move &move, Color player)
+    {
+        if (!isValidPosition(move.fromX, move.fromY) || !isValidPosition(move.toX, move.toY))
+        {
+            return PackedMove();
+        }
+
+        int from = squareIndex(move.fromX, move.fromY);
+        int to = squareIndex(move.toX, move.toY);
+        for (PackedMove legalMove: getAllPossibleMoves(player))
         {
-            for (int y = 0; y < 8; ++y)
+            if (legalMove.from() == from && legalMove.to() == to)
             {
-                if (board[x][y] != EMPTY_PIECE && board[x][y].color == opponent)
-                {
-                    Move move = {x, y, kingX, kingY};
-                    // Tymczasowo odblokuj sprawdzanie ruchu dla przeciwnika, aby wykryć atak na króla
-                    if (isValidAttackMove(move, opponent))
-                    {
-                        return true;
-                    }
-                }
+                return legalMove;
             }
         }
-        return false;
+        return PackedMove();
     }
 
-    // Nowa funkcja do sprawdzania ataku, bez sprawdzania szacha
-    bool isValidAttackMove(const Move &move, Color player) const
+    bool isValidMove(const Move &move, Color player)
     {
-        if (!isValidPosition(move.fromX, move.fromY) || !isValidPosition(move.toX, move.toY))
+        return !findLegalMove(move, player).isNull();
+    }
+
+    // Ruch partii z GUI: ta sama ścieżka co w wyszukiwaniu, a do tego notacja, historia i stan gry
+    void makeMove(const Move &move)
+    {
+        PackedMove legalMove = findLegalMove(move, currentPlayer);
+        if (legalMove.isNull())
         {
-            return false;
+            logger.log("Invalid move attempted!", Logger::ERROR);
+            return;
         }
 
-        Piece piece = board[move.fromX][move.fromY];
-        if (piece == EMPTY_PIECE || piece.color != player)
+        doMove(legalMove);
+        searchPly = 0; // Ruch partii jest nowym korzeniem dla kolejnego wyszukiwania
+
+        // Figurę wybiera gracz już po ruchu; do tego czasu stoi hetman, którego zamieni promotePawn
+        if (legalMove.flag() == PROMOTION_MOVE)
         {
-            return false;
+            isPawnPromotionPending = true;
+            promotionX = move.toX;
+            promotionY = move.toY;
         }
 
-        Piece target = board[move.toX][move.toY];
-        if (target != EMPTY_PIECE && target.color == piece.color)
+        std::string notation = generateAlgebraicNotation(move, undoStack.back());
+        moveHistory.emplace_back(move.fromX, move.fromY, move.toX, move.toY, notation);
+
+        // Aktualizacja licznika powtórek ruchów
+        std::string moveKey = std::to_string(move.fromX) + std::to_string(move.fromY) + std::to_string(move.toX) +
+                              std::to_string(move.toY);
+        moveRepetitionCount[moveKey]++;
+
+        checkGameState();
+    }
+
+    // Wykonanie ruchu legalnego. Rodzaj ruchu (promocja, bicie w przelocie, roszada) zapisany jest w samym ruchu,
+    // a stan potrzebny do cofnięcia trafia na stos, więc undoMove nie potrzebuje argumentów.
+    void doMove(const PackedMove &move)
+    {
+        int from = move.from();
+        int to = move.to();
+        int capturedSquare = move.flag() == EN_PASSANT_MOVE ? squareIndex(squareRow(from), squareColumn(to)) : to;
+        Piece moved = pieceOn(from);
+        Piece captured = pieceOn(capturedSquare);
+        undoStack.push_back({move, moved, captured, static_cast<uint8_t>(castlingRights),
+                             static_cast<int8_t>(enPassantTargetX), static_cast<int8_t>(enPassantTargetY),
+                             halfmoveClock, hashKey});
+        hashKey ^= stateKey();
+
+        if (captured != EMPTY_PIECE)
         {
-            return false;
+            removePiece(capturedSquare);
         }
-
-        bool validPieceMove = false;
-        switch (piece.type)
+        if (move.flag() == CASTLING_MOVE)
         {
-            case PAWN:
-            {
-                int direction = (piece.color == WHITE) ? -1 : 1;
-                if (abs(move.fromY - move.toY) == 1 && move.toX == move.fromX + direction)
-                {
-                    validPieceMove = true;
-                }
-                break;
-            }
-            case KNIGHT:
+            int row = squareRow(from);
+            if (to > from)
             {
-                int dx = abs(move.toX - move.fromX);
-                int dy = abs(move.toY - move.fromY);
-                validPieceMove = (dx == 2 && dy == 1) || (dx == 1 && dy == 2);
-                break;
+                movePiece(squareIndex(row, 7), from + 1);
             }
-            case BISHOP:
+            else
             {
-                if (abs(move.toX - move.fromX) == abs(move.toY - move.fromY))
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
-                break;
+                movePiece(squareIndex(row, 0), from - 1);
             }
-            case ROOK:
-            {
-                if (move.toX == move.fromX || move.toY == move.fromY)
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
-                break;
-            }
-            case QUEEN:
-            {
-                if (move.toX == move.fromX || move.toY == move.fromY ||
-                    abs(move.toX - move.fromX) == abs(move.toY - move.fromY))
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
-                break;
-            }
-            case KING:
-            {
-                int dx = abs(move.toX - move.fromX);
-                int dy = abs(move.toY - move.fromY);
-                validPieceMove = (dx <= 1 && dy <= 1);
-                break;
-            }
-            default:
-                return false;
         }
+        removePiece(from);
+        putPiece(to, move.flag() == PROMOTION_MOVE ? Piece(move.promotion(), moved.color) : moved);
 
-        return validPieceMove;
-    }
-
-    bool isPathClear(int fromX, int fromY, int toX, int toY) const
-    {
-        int dx = (toX == fromX) ? 0 : (toX > fromX ? 1 : -1);
-        int dy = (toY == fromY) ? 0 : (toY > fromY ? 1 : -1);
-        int x = fromX + dx;
-        int y = fromY + dy;
-
-        while (x != toX || y != toY)
+        castlingRights &= castlingRightsKept(from) & castlingRightsKept(to);
+        halfmoveClock = (moved.type == PAWN || captured != EMPTY_PIECE) ? 0 : halfmoveClock + 1;
+        if (moved.type == PAWN && abs(squareRow(to) - squareRow(from)) == 2)
         {
-            if (!isValidPosition(x, y) || board[x][y] != EMPTY_PIECE)
-            {
-                return false;
-            }
-            x += dx;
-            y += dy;
+            enPassantTargetX = (squareRow(from) + squareRow(to)) / 2;
+            enPassantTargetY = squareColumn(from);
         }
-        return true;
-    }
-
-
-    bool isValidMove(const Move &move, Color player)
-    {
-        if (!isValidPosition(move.fromX, move.fromY) || !isValidPosition(move.toX, move.toY))
-        {
-            return false;
-        }
-
-        Piece piece = board[move.fromX][move.fromY];
-        if (piece == EMPTY_PIECE || piece.color != currentPlayer)
+        else
         {
-            return false;
+            enPassantTargetX = -1;
+            enPassantTargetY = -1;
         }
 
-        if (piece.color != player)
-        {
-            return false;
-        }
+        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+        hashKey ^= stateKey() ^ zobrist().side;
+        searchPly++;
+    }
 
-        Piece target = board[move.toX][move.toY];
-        if (target != EMPTY_PIECE)
+    // Cofnięcie ostatniego ruchu ze stosu
+    void undoMove()
+    {
+        const GameState &state = undoStack.back();
+        int from = state.move.from();
+        int to = state.move.to();
+        removePiece(to);
+        putPiece(from, state.movedPiece);
+        if (state.move.flag() == CASTLING_MOVE)
         {
-            if (target.color == piece.color)
+            int row = squareRow(from);
+            if (to > from)
             {
-                return false;
+                movePiece(from + 1, squareIndex(row, 7));
             }
-            if (target.type == KING)
+            else
             {
-                return false;
+                movePiece(from - 1, squareIndex(row, 0));
             }
         }
-
-        // Sprawdź poprawność ruchu dla danej figury
-        bool validPieceMove = false;
-        switch (piece.type)
+        if (state.capturedPiece != EMPTY_PIECE)
         {
-            case PAWN:
-            {
-                int direction = (piece.color == WHITE) ? -1 : 1;
-                int startRow = (piece.color == WHITE) ? 6 : 1;
+            putPiece(state.move.flag() == EN_PASSANT_MOVE ? squareIndex(squareRow(from), squareColumn(to)) : to,
+                     state.capturedPiece);
+        }
 
-                if (move.fromY == move.toY && move.toX == move.fromX + direction && target == EMPTY_PIECE)
-                {
-                    validPieceMove = true;
-                }
+        castlingRights = state.castlingRights;
+        enPassantTargetX = state.enPassantTargetX;
+        enPassantTargetY = state.enPassantTargetY;
+        halfmoveClock = state.halfmoveClock;
+        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+        hashKey = state.hashKey;
+        undoStack.pop_back();
+        searchPly--;
+    }
 
-                if (move.fromY == move.toY && move.fromX == startRow && move.toX == move.fromX + 2 * direction &&
-                    target == EMPTY_PIECE && board[move.fromX + direction][move.fromY] == EMPTY_PIECE)
-                {
-                    validPieceMove = true;
-                }
+    // Pusty ruch dla null move pruning: strona na posunięciu oddaje ruch, bicie w przelocie przepada.
+    // Na stosie zostaje rekord z pustym ruchem, więc previousMove() widzi, że poprzedni ruch był pusty.
+    void doNullMove()
+    {
+        undoStack.push_back({PackedMove(), EMPTY_PIECE, EMPTY_PIECE, static_cast<uint8_t>(castlingRights),
+                             static_cast<int8_t>(enPassantTargetX), static_cast<int8_t>(enPassantTargetY),
+                             halfmoveClock, hashKey});
+        hashKey ^= stateKey();
+        enPassantTargetX = -1;
+        enPassantTargetY = -1;
+        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+        hashKey ^= stateKey() ^ zobrist().side;
+        searchPly++;
+    }
 
-                if (abs(move.fromY - move.toY) == 1 && move.toX == move.fromX + direction &&
-                    (target != EMPTY_PIECE || (move.toX == enPassantTargetX && move.toY == enPassantTargetY)))
-                {
-                    if (target != EMPTY_PIECE)
-                    {
-                        validPieceMove = true;
-                    }
-                    else if (move.toX == enPassantTargetX && move.toY == enPassantTargetY)
-                    {
-                        int capturedPawnX = move.fromX;
-                        if (isValidPosition(capturedPawnX, move.toY) && board[capturedPawnX][move.toY].type == PAWN &&
-                            board[capturedPawnX][move.toY].color != piece.color)
-                        {
-                            validPieceMove = true;
-                        }
-                    }
-                }
+    void undoNullMove()
+    {
+        const GameState &state = undoStack.back();
+        enPassantTargetX = state.enPassantTargetX;
+        enPassantTargetY = state.enPassantTargetY;
+        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+        hashKey = state.hashKey;
+        undoStack.pop_back();
+        searchPly--;
+    }
 
-                break;
-            }
-            case KNIGHT:
-            {
-                int dx = abs(move.toX - move.fromX);
-                int dy = abs(move.toY - move.fromY);
-                validPieceMove = (dx == 2 && dy == 1) || (dx == 1 && dy == 2);
-                break;
-            }
-            case BISHOP:
-            {
-                if (abs(move.toX - move.fromX) == abs(move.toY - move.fromY))
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
+    bool isPromotionPending() const
+    {
+        return isPawnPromotionPending;
+    }
 
-                break;
-            }
-            case ROOK:
+    void promotePawn()
+    {
+        if (isPawnPromotionPending &&
+            (promotionChoice == QUEEN || promotionChoice == ROOK || promotionChoice == BISHOP ||
+             promotionChoice == KNIGHT))
+        {
+            int square = squareIndex(promotionX, promotionY);
+            Color color = pieceOn(square).color;
+            replacePiece(square, Piece(promotionChoice, color));
+            if (!undoStack.empty() && undoStack.back().move.flag() == PROMOTION_MOVE)
             {
-                if (move.toX == move.fromX || move.toY == move.fromY)
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
-
-                break;
+                PackedMove &promotion = undoStack.back().move;
+                promotion = PackedMove(promotion.from(), promotion.to(), PROMOTION_MOVE, promotionChoice);
             }
-            case QUEEN:
-            {
-                if (move.toX == move.fromX || move.toY == move.fromY ||
-                    abs(move.toX - move.fromX) == abs(move.toY - move.fromY))
-                {
-                    validPieceMove = isPathClear(move.fromX, move.fromY, move.toX, move.toY);
-                }
+            logger.log("Pawn promoted to " + std::to_string(promotionChoice), Logger::INFO);
 
-                break;
-            }
-            case KING:
+            // Figura promocji znana jest dopiero teraz, więc dopisujemy ją do notacji ostatniego ruchu,
+            // a szach i mat sprawdzamy ponownie z nową figurą
+            if (!moveHistory.empty())
             {
-                int dx = abs(move.toX - move.fromX);
-                int dy = abs(move.toY - move.fromY);
-                if (dx <= 1 && dy <= 1)
+                std::string &notation = moveHistory.back().notation;
+                while (!notation.empty() && (notation.back() == '+' || notation.back() == '#'))
                 {
-                    validPieceMove = true;
+                    notation.pop_back();
                 }
-
-                if (piece.color == WHITE && move.fromX == 7 && move.fromY == 4)
+                char symbol = static_cast<char>(toupper(pieceToChar(promotionChoice)));
+                notation += "=";
+                notation += color == BLACK ? static_cast<char>(tolower(symbol)) : symbol;
+                if (isInCheck(currentPlayer))
                 {
-                    if (move.toX == 7 && move.toY == 6 && whiteCanCastleKingside && board[7][5] == EMPTY_PIECE &&
-                        board[7][6] == EMPTY_PIECE && board[7][7].type == ROOK && board[7][7].color == WHITE &&
-                        !isInCheck(WHITE))
-                    {
-                        // Sprawdź, czy pola pośrednie są szachowane
-                        Piece temp = board[7][5];
-                        board[7][5] = board[7][4];
-                        bool check1 = isInCheck(WHITE);
-                        board[7][5] = temp;
-                        if (check1)
-                        {
-                            return false;
-                        }
-
-                        temp = board[7][6];
-                        board[7][6] = board[7][4];
-                        bool check2 = isInCheck(WHITE);
-                        board[7][6] = temp;
-                        if (check2)
-                        {
-                            return false;
-                        }
-
-                        validPieceMove = true;
-                    }
-                    else if (move.toX == 7 && move.toY == 2 && whiteCanCastleQueenside && board[7][1] == EMPTY_PIECE &&
-                             board[7][2] == EMPTY_PIECE && board[7][3] == EMPTY_PIECE && board[7][0].type == ROOK &&
-                             board[7][0].color == WHITE && !isInCheck(WHITE))
-                    {
-                        Piece temp = board[7][3];
-                        board[7][3] = board[7][4];
-                        bool check1 = isInCheck(WHITE);
-                        board[7][3] = temp;
-                        if (check1)
-                        {
-                            return false;
-                        }
-
-                        temp = board[7][2];
-                        board[7][2] = board[7][4];
-                        bool check2 = isInCheck(WHITE);
-                        board[7][2] = temp;
-                        if (check2)
-                        {
-                            return false;
-                        }
-
-                        validPieceMove = true;
-                    }
+                    notation += getAllPossibleMoves(currentPlayer).empty() ? "#" : "+";
                 }
-                else if (piece.color == BLACK && move.fromX == 0 && move.fromY == 4)
-                {
-                    if (move.toX == 0 && move.toY == 6 && blackCanCastleKingside && board[0][5] == EMPTY_PIECE &&
-                        board[0][6] == EMPTY_PIECE && board[0][7].type == ROOK && board[0][7].color == BLACK &&
-                        !isInCheck(BLACK))
-                    {
-                        Piece temp = board[0][5];
-                        board[0][5] = board[0][4];
-                        bool check1 = isInCheck(BLACK);
-                        board[0][5] = temp;
-                        if (check1)
-                        {
-                            return false;
-                        }
-
-                        temp = board[0][6];
-                        board[0][6] = board[0][4];
-                        bool check2 = isInCheck(BLACK);
-                        board[0][6] = temp;
-                        if (check2)
-                        {
-                            return false;
-                        }
-
-                        validPieceMove = true;
-                    }
-                    else if (move.toX == 0 && move.toY == 2 && blackCanCastleQueenside && board[0][1] == EMPTY_PIECE &&
-                             board[0][2] == EMPTY_PIECE && board[0][3] == EMPTY_PIECE && board[0][0].type == ROOK &&
-                             board[0][0].color == BLACK && !isInCheck(BLACK))
-                    {
-                        Piece temp = board[0][3];
-                        board[0][3] = board[0][4];
-                        bool check1 = isInCheck(BLACK);
-                        board[0][3] = temp;
-                        if (check1)
-                        {
-                            return false;
-                        }
-
-                        temp = board[0][2];
-                        board[0][2] = board[0][4];
-                        bool check2 = isInCheck(BLACK);
-                        board[0][2] = temp;
-                        if (check2)
-                        {
-                            return false;
-                        }
-
-                        validPieceMove = true;
-                    }
-                }
-
-                break;
             }
-            default:
-                return false;
-        }
-
-        if (!validPieceMove)
-        {
-            return false;
+            isPawnPromotionPending = false;
+            promotionX = -1;
+            promotionY = -1;
+            checkGameState();
         }
+    }
 
-        // Sprawdź, czy ruch nie zostawia króla w szachu
-        Piece capturedPiece = board[move.toX][move.toY];
-        board[move.toX][move.toY] = board[move.fromX][move.fromY];
-        board[move.fromX][move.fromY] = EMPTY_PIECE;
-
-        bool inCheck = isInCheck(player);
-
-        // Przywróć stan planszy
-        board[move.fromX][move.fromY] = board[move.toX][move.toY];
-        board[move.toX][move.toY] = capturedPiece;
-
-        return !inCheck;
+    bool isGameOver() const
+    {
+        return gameOverState;
     }
 
-    void makeMove(const Move &move)
+    bool isCheckmateState() const
     {
-        if (!isValidMove(move, currentPlayer))
-        {
-            logger.log("Invalid move attempted!", Logger::ERROR);
-            return;
-        }
+        return isCheckmate;
+    }
 
-        GameState state{board[move.toX][move.toY], whiteCanCastleKingside, whiteCanCastleQueenside,
-                        blackCanCastleKingside, blackCanCastleQueenside, enPassantTargetX, enPassantTargetY, move,
-                        board[move.fromX][move.fromY]};
+    bool isStalemateState() const
+    {
+        return isStalemate;
+    }
 
-        Piece piece = board[move.fromX][move.fromY];
-        int direction = (piece.color == WHITE) ? -1 : 1;
-        int startRow = (piece.color == WHITE) ? 6 : 1;
+    void checkGameState()
+    {
+        // Sprawdź, czy król istnieje
+        int pieceCount = popCount(occupied[WHITE] | occupied[BLACK]);
+        int kingCount = popCount(pieces[WHITE][KING]) + popCount(pieces[BLACK][KING]);
+        Color missingKingColor = pieces[WHITE][KING] ? BLACK : WHITE;
 
-        if (piece.type == KING)
-        {
-            if (piece.color == WHITE)
-            {
-                whiteCanCastleKingside = false;
-                whiteCanCastleQueenside = false;
-            }
-            else
-            {
-                blackCanCastleKingside = false;
-                blackCanCastleQueenside = false;
-            }
-        }
-        if (piece.type == ROOK)
+        if (pieceCount == 2 && kingCount == 2)
         {
-            if (piece.color == WHITE)
-            {
-                if (move.fromX == 7 && move.fromY == 0)
-                {
-                    whiteCanCastleQueenside = false;
-                }
-                if (move.fromX == 7 && move.fromY == 7)
-                {
-                    whiteCanCastleKingside = false;
-                }
-            }
-            else
-            {
-                if (move.fromX == 0 && move.fromY == 0)
-                {
-                    blackCanCastleQueenside = false;
-                }
-                if (move.fromX == 0 && move.fromY == 7)
-                {
-                    blackCanCastleKingside = false;
-                }
-            }
+            isCheckmate = false;
+            isStalemate = true;
+            gameOverState = true;
+            logger.log("Draw! Only two kings remain.", Logger::INFO);
+            return;
         }
 
-        if (piece.type == PAWN && move.toX == enPassantTargetX && move.toY == enPassantTargetY)
+        if (kingCount < 2)
         {
-            int captureDir = (piece.color == WHITE) ? 1 : -1;
-            int capturedPawnX = move.toX + captureDir;
-            if (isValidPosition(capturedPawnX, move.toY) && board[capturedPawnX][move.toY].type == PAWN &&
-                board[capturedPawnX][move.toY].color != piece.color)
-            {
-                board[capturedPawnX][move.toY] = EMPTY_PIECE;
-            }
+            isCheckmate = true;
+            isStalemate = false;
+            gameOverState = true;
+            logger.log(std::string(missingKingColor == WHITE ? "Black" : "White") + " wins by capturing king!",
+                       Logger::SUCCESS);
+            return;
         }
 
-        if (piece.type == PAWN && move.fromX == startRow && abs(move.toX - move.fromX) == 2)
-        {
-            enPassantTargetX = move.fromX + direction;
-            enPassantTargetY = move.fromY;
-        }
-        else
+        MoveList moves = getAllPossibleMoves(currentPlayer);
+        bool inCheck = isInCheck(currentPlayer);
+        if (halfmoveClock >= 100 && !(inCheck && moves.empty()))
         {
-            enPassantTargetX = -1;
-            enPassantTargetY = -1;
+            isCheckmate = false;
+            isStalemate = true;
+            gameOverState = true;
+            logger.log("Draw by the fifty-move rule.", Logger::INFO);
+            return;
         }
-
-        if (piece.type == KING && abs(move.toY - move.fromY) == 2)
+        if (moves.empty())
         {
-            if (move.toY > move.fromY)
+            if (inCheck)
             {
-                board[move.fromX][move.fromY + 1] = board[move.fromX][7];
-                board[move.fromX][7] = EMPTY_PIECE;
+                isCheckmate = true;
+                isStalemate = false;
+                gameOverState = true;
+                logger.log(currentPlayer == WHITE ? "Black wins by checkmate!" : "White wins by checkmate!",
+                           Logger::SUCCESS);
             }
             else
             {
-                board[move.fromX][move.fromY - 1] = board[move.fromX][0];
-                board[move.fromX][0] = EMPTY_PIECE;
+                isCheckmate = false;
+                isStalemate = true;
+                gameOverState = true;
+                logger.log("Stalemate! Game is a draw.", Logger::INFO);
             }
         }
-
-        board[move.toX][move.toY] = board[move.fromX][move.fromY];
-        board[move.fromX][move.fromY] = EMPTY_PIECE;
-
-        if (piece.type == PAWN && (move.toX == 0 || move.toX == 7))
+        else if (inCheck)
         {
-            isPawnPromotionPending = true;
-            promotionX = move.toX;
-            promotionY = move.toY;
+            logger.log(currentPlayer == WHITE ? "White is in check!" : "Black is in check!", Logger::WARN);
         }
-
-        std::string notation = generateAlgebraicNotation(move, state);
-        moveHistory.emplace_back(move.fromX, move.fromY, move.toX, move.toY, notation);
-
-        // Aktualizacja licznika powtórek ruchów
-        std::string moveKey = std::to_string(move.fromX) + std::to_string(move.fromY) + std::to_string(move.toX) +
-                              std::to_string(move.toY);
-        moveRepetitionCount[moveKey]++;
-
-        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
-        checkGameState();
     }
 
-    // Wykonaj tymczasowy ruch i zwróć stan gry
-    GameState makeTemporaryMove(const Move &move)
+    void resetGame()
     {
-        GameState state{board[move.toX][move.toY], whiteCanCastleKingside, whiteCanCastleQueenside,
-                        blackCanCastleKingside, blackCanCastleQueenside, enPassantTargetX, enPassantTargetY, move,
-                        board[move.fromX][move.fromY]};
+        initializeBoard();
+        currentPlayer = WHITE;
+        isCheckmate = false;
+        isStalemate = false;
+        gameOverState = false;
+        castlingRights = ALL_CASTLING;
+        enPassantTargetX = -1;
+        enPassantTargetY = -1;
+        halfmoveClock = 0;
+        isPawnPromotionPending = false;
+        promotionX = -1;
+        promotionY = -1;
+        promotionChoice = QUEEN;
+        hashKey = computeHashKey();
+        moveHistory.clear();
+        undoStack.clear();
+        searchPly = 0;
+        moveRepetitionCount.clear();
+        transpositionTable.clear();
+        pawnTable.clear();
+        clearMoveOrdering();
+        logger.log("Game reset.", Logger::INFO);
+    }
 
-        int direction = (state.movedPiece.color == WHITE) ? -1 : 1;
-        int startRow = (state.movedPiece.color == WHITE) ? 6 : 1;
+    // Ustawienie pozycji z zapisu FEN (numer posunięcia jest pomijany). Przy błędnym zapisie pozycja się nie zmienia.
+    bool loadFen(const std::string &fen)
+    {
+        std::istringstream stream(fen);
+        std::string placement, side, castling, enPassant;
+        int halfmoves = 0;
+        stream >> placement >> side >> castling >> enPassant >> halfmoves;
 
-        if (state.movedPiece.type == KING)
+        Piece parsed[64];
+        int square = 0;
+        int kings[2] = {0, 0};
+        bool valid = side == "w" || side == "b";
+        for (char c: placement)
         {
-            if (state.movedPiece.color == WHITE)
+            PieceType type;
+            if (c == '/')
             {
-                whiteCanCastleKingside = false;
-                whiteCanCastleQueenside = false;
+                continue;
             }
-            else
+            if (c >= '1' && c <= '8')
             {
-                blackCanCastleKingside = false;
-                blackCanCastleQueenside = false;
+                square += c - '0';
             }
-        }
-        if (state.movedPiece.type == ROOK)
-        {
-            if (state.movedPiece.color == WHITE)
+            else if (square < 64 && pieceTypeFromChar(c, type))
             {
-                if (move.fromX == 7 && move.fromY == 0)
-                {
-                    whiteCanCastleQueenside = false;
-                }
-                if (move.fromX == 7 && move.fromY == 7)
-                {
-                    whiteCanCastleKingside = false;
-                }
+                Color color = (c >= 'A' && c <= 'Z') ? WHITE : BLACK;
+                kings[color] += type == KING;
+                parsed[square++] = Piece(type, color);
             }
             else
             {
-                if (move.fromX == 0 && move.fromY == 0)
-                {
-                    blackCanCastleQueenside = false;
-                }
-                if (move.fromX == 0 && move.fromY == 7)
-                {
-                    blackCanCastleKingside = false;
-                }
+                valid = false;
             }
         }
+        if (!valid || square != 64 || kings[WHITE] != 1 || kings[BLACK] != 1)
+        {
+            logger.log("Invalid FEN: " + fen, Logger::ERROR);
+            return false;
+        }
 
-        if (state.movedPiece.type == PAWN && move.toX == state.enPassantTargetX && move.toY == state.enPassantTargetY)
+        clearBoard();
+        for (square = 0; square < 64; ++square)
         {
-            int captureDir = (state.movedPiece.color == WHITE) ? 1 : -1;
-            int capturedPawnX = move.toX + captureDir;
-            if (isValidPosition(capturedPawnX, move.toY) && board[capturedPawnX][move.toY].type == PAWN &&
-                board[capturedPawnX][move.toY].color != state.movedPiece.color)
+            if (parsed[square] != EMPTY_PIECE)
             {
-                board[capturedPawnX][move.toY] = EMPTY_PIECE;
+                putPiece(square, parsed[square]);
             }
         }
-
-        if (state.movedPiece.type == PAWN && move.fromX == startRow && abs(move.toX - move.fromX) == 2)
+        currentPlayer = side == "w" ? WHITE : BLACK;
+        castlingRights = (castling.find('K') != std::string::npos ? WHITE_KINGSIDE : 0) |
+                         (castling.find('Q') != std::string::npos ? WHITE_QUEENSIDE : 0) |
+                         (castling.find('k') != std::string::npos ? BLACK_KINGSIDE : 0) |
+                         (castling.find('q') != std::string::npos ? BLACK_QUEENSIDE : 0);
+        halfmoveClock = std::max(halfmoves, 0);
+        if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && enPassant[1] >= '1' &&
+            enPassant[1] <= '8')
         {
-            enPassantTargetX = move.fromX + direction;
-            enPassantTargetY = move.fromY;
+            enPassantTargetX = '8' - enPassant[1];
+            enPassantTargetY = enPassant[0] - 'a';
         }
         else
         {
@@ -1039,486 +1002,350 @@ public:
             enPassantTargetY = -1;
         }
 
-        if (state.movedPiece.type == KING && abs(move.toY - move.fromY) == 2)
+        isCheckmate = false;
+        isStalemate = false;
+        gameOverState = false;
+        isPawnPromotionPending = false;
+        promotionX = -1;
+        promotionY = -1;
+        hashKey = computeHashKey();
+        moveHistory.clear();
+        undoStack.clear();
+        searchPly = 0;
+        moveRepetitionCount.clear();
+        return true;
+    }
+
+    // Liczba liści drzewa ruchów legalnych o danej głębokości - test poprawności i szybkości generatora.
+    // Z tabelą poddrzewa osiągane przez transpozycję są liczone tylko raz.
+    uint64_t perft(int depth, PerftTable *table = nullptr)
+    {
+        if (depth == 0)
         {
-            if (move.toY > move.fromY)
-            {
-                board[move.fromX][move.fromY + 1] = board[move.fromX][7];
-                board[move.fromX][7] = EMPTY_PIECE;
-            }
-            else
-            {
-                board[move.fromX][move.fromY - 1] = board[move.fromX][0];
-                board[move.fromX][0] = EMPTY_PIECE;
-            }
+            return 1;
         }
 
-        board[move.toX][move.toY] = board[move.fromX][move.fromY];
-        board[move.fromX][move.fromY] = EMPTY_PIECE;
+        uint64_t nodes = 0;
+        if (table && depth > 1 && table->probe(hashKey, depth, nodes))
+        {
+            return nodes;
+        }
 
-        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
-        return state;
+        MoveList &moves = moveStack[searchPly];
+        getAllPossibleMoves(currentPlayer, moves);
+        if (depth == 1)
+        {
+            return moves.size();
+        }
+
+        for (PackedMove move: moves)
+        {
+            doMove(move);
+            nodes += perft(depth - 1, table);
+            undoMove();
+        }
+        if (table)
+        {
+            table->store(hashKey, depth, nodes);
+        }
+        return nodes;
     }
 
-    // Cofnij tymczasowy ruch
-    void undoMove(const GameState &state)
+    // Perft z liczbą liści osobno dla każdego ruchu z korzenia
+    uint64_t perftDivide(int depth, std::ostream &out = std::cout)
     {
-        board[state.move.fromX][state.move.fromY] = state.movedPiece;
-        board[state.move.toX][state.move.toY] = state.capturedPiece;
+        MoveList moves = getAllPossibleMoves(currentPlayer);
+        uint64_t total = 0;
+        for (PackedMove move: moves)
+        {
+            doMove(move);
+            uint64_t nodes = depth > 1 ? perft(depth - 1) : 1;
+            undoMove();
+            out << move.toString() << ": " << nodes << "\n";
+            total += nodes;
+        }
+        out << "Nodes: " << total << "\n";
+        return total;
+    }
 
-        if (state.movedPiece.type == PAWN && state.move.toX == state.enPassantTargetX &&
-            state.move.toY == state.enPassantTargetY)
-        {
-            int direction = (state.movedPiece.color == WHITE) ? 1 : -1;
-            board[state.move.toX + direction][state.move.toY] = Piece(PAWN, state.movedPiece.color == WHITE ? BLACK : WHITE);
-        }
+    const std::vector<Move> &getMoveHistory() const
+    {
+        return moveHistory;
+    }
 
-        if (state.movedPiece.type == KING && abs(state.move.toY - state.move.fromY) == 2)
+    // Figury gracza związane z własnym królem przez gońca, wieżę lub hetmana przeciwnika
+    Bitboard pinnedPieces(Color player, int kingSquare) const
+    {
+        Color opponent = (player == WHITE) ? BLACK : WHITE;
+        Bitboard occupancy = occupied[WHITE] | occupied[BLACK];
+        Bitboard snipers = (bishopAttacks(kingSquare, 0) & (pieces[opponent][BISHOP] | pieces[opponent][QUEEN])) |
+                           (rookAttacks(kingSquare, 0) & (pieces[opponent][ROOK] | pieces[opponent][QUEEN]));
+        Bitboard pinned = 0;
+        while (snipers)
         {
-            if (state.move.toY > state.move.fromY)
-            {
-                board[state.move.fromX][7] = board[state.move.fromX][state.move.fromY + 1];
-                board[state.move.fromX][state.move.fromY + 1] = EMPTY_PIECE;
-            }
-            else
+            Bitboard blockers = betweenBB(kingSquare, popLsb(snipers)) & occupancy;
+            if (blockers && !moreThanOne(blockers))
             {
-                board[state.move.fromX][0] = board[state.move.fromX][state.move.fromY - 1];
-                board[state.move.fromX][state.move.fromY - 1] = EMPTY_PIECE;
+                pinned |= blockers & occupied[player];
             }
         }
-
-        whiteCanCastleKingside = state.whiteCanCastleKingside;
-        whiteCanCastleQueenside = state.whiteCanCastleQueenside;
-        blackCanCastleKingside = state.blackCanCastleKingside;
-        blackCanCastleQueenside = state.blackCanCastleQueenside;
-        enPassantTargetX = state.enPassantTargetX;
-        enPassantTargetY = state.enPassantTargetY;
-
-        currentPlayer = (currentPlayer == WHITE) ? BLACK : WHITE;
+        return pinned;
     }
 
-    bool isPromotionPending() const
+    void addMoves(MoveList &moves, int from, Bitboard targets) const
     {
-        return isPawnPromotionPending;
+        while (targets)
+        {
+            moves.push_back(PackedMove(from, popLsb(targets)));
+        }
     }
 
-    void promotePawn()
+    // Promocja to cztery osobne ruchy, po jednym na każdą figurę (albo tylko hetman, gdy underpromotions == false)
+    void addPromotions(MoveList &moves, int from, Bitboard targets, bool underpromotions) const
     {
-        if (isPawnPromotionPending &&
-            (promotionChoice == QUEEN || promotionChoice == ROOK || promotionChoice == BISHOP ||
-             promotionChoice == KNIGHT))
+        while (targets)
         {
-            Color color = board[promotionX][promotionY].color;
-            board[promotionX][promotionY] = Piece(promotionChoice, color);
-            logger.log("Pawn promoted to " + std::to_string(promotionChoice), Logger::INFO);
-            isPawnPromotionPending = false;
-            promotionX = -1;
-            promotionY = -1;
-            checkGameState();
+            int to = popLsb(targets);
+            moves.push_back(PackedMove(from, to, PROMOTION_MOVE, QUEEN));
+            if (!underpromotions)
+            {
+                continue;
+            }
+            moves.push_back(PackedMove(from, to, PROMOTION_MOVE, ROOK));
+            moves.push_back(PackedMove(from, to, PROMOTION_MOVE, BISHOP));
+            moves.push_back(PackedMove(from, to, PROMOTION_MOVE, KNIGHT));
         }
     }
 
-    bool isGameOver() const
+    // Generator ruchów legalnych. Związania i maska wyjścia z szacha liczone są raz na pozycję,
+    // więc żaden ruch nie jest wykonywany na próbę.
+    MoveList getAllPossibleMoves(Color player)
     {
-        return gameOverState;
+        MoveList moves;
+        getAllPossibleMoves(player, moves);
+        return moves;
     }
 
-    bool isCheckmateState() const
+    // Wersja dla wyszukiwania: ruchy trafiają do listy z gotowego stosu, bez kopiowania
+    void getAllPossibleMoves(Color player, MoveList &moves)
     {
-        return isCheckmate;
+        generateMoves(player, moves, false);
     }
 
-    bool isStalemateState() const
+    // Tylko bicia (z biciem w przelocie) i promocje do hetmana - ruchy przeszukiwane w quiescenceSearch.
+    // Z quietChecks dochodzą ciche ruchy dające bezpośredniego szacha (bez szachów odsłoniętych i roszad).
+    void getCaptureMoves(Color player, MoveList &moves, bool quietChecks = false)
     {
-        return isStalemate;
+        generateMoves(player, moves, true, quietChecks);
     }
 
-    void checkGameState()
-    {
-        // Sprawdź, czy król istnieje
-        int pieceCount = 0;
-        int kingCount = 0;
-        Color missingKingColor = static_cast<Color>(-1); // Domyślnie, dla kompilacji
-        for (int i = 0; i < 8; ++i)
+    void generateMoves(Color player, MoveList &moves, bool capturesOnly, bool quietChecks = false)
+    {
+        moves.clear();
+        // Ruchy legalne ma tylko strona, która jest na posunięciu
+        if (player != currentPlayer || pieces[player][KING] == 0)
+        {
+            return;
+        }
+
+        Color opponent = (player == WHITE) ? BLACK : WHITE;
+        Bitboard occupancy = occupied[WHITE] | occupied[BLACK];
+        int kingSquare = lsb(pieces[player][KING]);
+        Bitboard checkers = attackersTo(kingSquare, occupancy) & occupied[opponent];
+        Bitboard pinned = pinnedPieces(player, kingSquare);
+
+        // Pola, z których figura danego typu atakowałaby króla przeciwnika - cele cichych szachów
+        Bitboard checkSquares[6] = {0, 0, 0, 0, 0, 0};
+        if (quietChecks && pieces[opponent][KING])
         {
-            for (int j = 0; j < 8; ++j)
+            int enemyKing = lsb(pieces[opponent][KING]);
+            checkSquares[PAWN] = pawnAttacks(enemyKing, opponent) & ~occupancy;
+            checkSquares[KNIGHT] = knightAttacks(enemyKing) & ~occupancy;
+            checkSquares[BISHOP] = bishopAttacks(enemyKing, occupancy) & ~occupancy;
+            checkSquares[ROOK] = rookAttacks(enemyKing, occupancy) & ~occupancy;
+            checkSquares[QUEEN] = checkSquares[BISHOP] | checkSquares[ROOK];
+        }
+
+        // Król: pole docelowe sprawdzamy bez króla na planszy, żeby nie zasłaniał linii ataku
+        Bitboard captureMask = capturesOnly ? occupied[opponent] : FULL_BB;
+        Bitboard kingTargets = kingAttacks(kingSquare) & ~occupied[player] & captureMask;
+        Bitboard occupancyWithoutKing = occupancy ^ squareBB(kingSquare);
+        while (kingTargets)
+        {
+            int to = popLsb(kingTargets);
+            if ((attackersTo(to, occupancyWithoutKing) & occupied[opponent]) == 0)
             {
-                if (board[i][j] != EMPTY_PIECE)
-                {
-                    pieceCount++;
-                    if (board[i][j].type == KING)
-                    {
-                        kingCount++;
-                        if (board[i][j].color == WHITE)
-                        {
-                            missingKingColor = BLACK;
-                        }
-                        else
-                        {
-                            missingKingColor = WHITE;
-                        }
-                    }
-                }
+                addMoves(moves, kingSquare, squareBB(to));
             }
         }
 
-        if (pieceCount == 2 && kingCount == 2)
+        // Przy podwójnym szachu rusza się tylko król
+        if (moreThanOne(checkers))
         {
-            isCheckmate = false;
-            isStalemate = true;
-            gameOverState = true;
-            logger.log("Draw! Only two kings remain.", Logger::INFO);
             return;
         }
 
-        if (kingCount < 2)
+        // Przy szachu wolno tylko zbić szachującą figurę albo zasłonić króla
+        Bitboard checkMask = checkers ? (betweenBB(kingSquare, lsb(checkers)) | checkers) : FULL_BB;
+        Bitboard targetMask = ~occupied[player] & checkMask & captureMask;
+
+        for (int type = KNIGHT; type <= QUEEN; ++type)
         {
-            isCheckmate = true;
-            isStalemate = false;
-            gameOverState = true;
-            logger.log(std::string(missingKingColor == WHITE ? "Black" : "White") + " wins by capturing king!",
-                       Logger::SUCCESS);
-            return;
+            Bitboard playerPieces = pieces[player][type];
+            while (playerPieces)
+            {
+                int from = popLsb(playerPieces);
+                Bitboard targets = attacksFrom(Piece(static_cast<PieceType>(type), player), from, occupancy) &
+                                   (targetMask | (checkSquares[type] & checkMask));
+                if (pinned & squareBB(from))
+                {
+                    targets &= lineBB(kingSquare, from);
+                }
+                addMoves(moves, from, targets);
+            }
         }
 
-        std::vector<Move> moves = getAllPossibleMoves(currentPlayer);
-        bool inCheck = isInCheck(currentPlayer);
-        if (moves.empty())
+        int startRow = (player == WHITE) ? 6 : 1;
+        int epSquare = enPassantTargetX != -1 ? squareIndex(enPassantTargetX, enPassantTargetY) : -1;
+        Bitboard pawns = pieces[player][PAWN];
+        while (pawns)
         {
-            if (inCheck)
+            int from = popLsb(pawns);
+            Bitboard pushes = pawnPush(squareBB(from), player) & ~occupancy;
+            if (pushes && squareRow(from) == startRow)
             {
-                isCheckmate = true;
-                isStalemate = false;
-                gameOverState = true;
-                logger.log(currentPlayer == WHITE ? "Black wins by checkmate!" : "White wins by checkmate!",
-                           Logger::SUCCESS);
+                pushes |= pawnPush(pushes, player) & ~occupancy;
             }
-            else
+            if (capturesOnly)
             {
-                isCheckmate = false;
-                isStalemate = true;
-                gameOverState = true;
-                logger.log("Stalemate! Game is a draw.", Logger::INFO);
+                pushes &= ROW_0_BB | ROW_7_BB | checkSquares[PAWN];
+            }
+            Bitboard targets = (pushes | (pawnAttacks(from, player) & occupied[opponent])) & checkMask;
+            if (pinned & squareBB(from))
+            {
+                targets &= lineBB(kingSquare, from);
+            }
+            addMoves(moves, from, targets & ~(ROW_0_BB | ROW_7_BB));
+            addPromotions(moves, from, targets & (ROW_0_BB | ROW_7_BB), !capturesOnly);
+
+            // Bicie w przelocie: zbity pionek stoi w tym samym wierszu co bijący. Odsłonięcie króla
+            // (także poziome, po zdjęciu obu pionków) sprawdzamy na samych bitboardach.
+            if (epSquare != -1 && (pawnAttacks(from, player) & squareBB(epSquare)))
+            {
+                int capturedSquare = squareIndex(squareRow(from), enPassantTargetY);
+                if ((pieces[opponent][PAWN] & squareBB(capturedSquare)) &&
+                    (checkMask & (squareBB(epSquare) | squareBB(capturedSquare))))
+                {
+                    Bitboard after = (occupancy ^ squareBB(from) ^ squareBB(capturedSquare)) | squareBB(epSquare);
+                    bool exposed =
+                            (bishopAttacks(kingSquare, after) & (pieces[opponent][BISHOP] | pieces[opponent][QUEEN])) ||
+                            (rookAttacks(kingSquare, after) & (pieces[opponent][ROOK] | pieces[opponent][QUEEN]));
+                    if (!exposed)
+                    {
+                        moves.push_back(PackedMove(from, epSquare, EN_PASSANT_MOVE));
+                    }
+                }
             }
         }
-        else if (inCheck)
+
+        // Roszada: król nie może stać w szachu ani przechodzić przez atakowane pole
+        int homeRow = (player == WHITE) ? 7 : 0;
+        bool canCastleKingside = castlingRights & (player == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE);
+        bool canCastleQueenside = castlingRights & (player == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE);
+        if (!capturesOnly && !checkers && kingSquare == squareIndex(homeRow, 4))
         {
-            logger.log(currentPlayer == WHITE ? "White is in check!" : "Black is in check!", Logger::WARN);
+            if (canCastleKingside && (pieces[player][ROOK] & squareBB(squareIndex(homeRow, 7))) &&
+                !(occupancy & (squareBB(squareIndex(homeRow, 5)) | squareBB(squareIndex(homeRow, 6)))) &&
+                !isSquareAttacked(squareIndex(homeRow, 5), opponent) &&
+                !isSquareAttacked(squareIndex(homeRow, 6), opponent))
+            {
+                moves.push_back(PackedMove(kingSquare, squareIndex(homeRow, 6), CASTLING_MOVE));
+            }
+            if (canCastleQueenside && (pieces[player][ROOK] & squareBB(squareIndex(homeRow, 0))) &&
+                !(occupancy & (squareBB(squareIndex(homeRow, 1)) | squareBB(squareIndex(homeRow, 2)) |
+                               squareBB(squareIndex(homeRow, 3)))) &&
+                !isSquareAttacked(squareIndex(homeRow, 3), opponent) &&
+                !isSquareAttacked(squareIndex(homeRow, 2), opponent))
+            {
+                moves.push_back(PackedMove(kingSquare, squareIndex(homeRow, 2), CASTLING_MOVE));
+            }
         }
     }
 
-    void resetGame()
-    {
-        initializeBoard();
-        currentPlayer = WHITE;
-        isCheckmate = false;
-        isStalemate = false;
-        gameOverState = false;
-        whiteCanCastleKingside = true;
-        whiteCanCastleQueenside = true;
-        blackCanCastleKingside = true;
-        blackCanCastleQueenside = true;
-        enPassantTargetX = -1;
-        enPassantTargetY = -1;
-        isPawnPromotionPending = false;
-        promotionX = -1;
-        promotionY = -1;
-        promotionChoice = QUEEN;
-        moveHistory.clear();
-        moveRepetitionCount.clear();
-        transpositionTable.clear();
-        killerMoves.clear();
-        killerMoves.resize(MAX_DEPTH + 1, std::vector<Move>(2, Move(-1, -1, -1, -1)));
-        logger.log("Game reset.", Logger::INFO);
-    }
-
-    const std::vector<Move> &getMoveHistory() const
+    // Ocena pionków liczona tylko przy braku wpisu w tabeli pionków
+    PawnEntry &probePawnStructure()
     {
-        return moveHistory;
-    }
+        PawnEntry &entry = pawnTable.entry(pawnKey);
+        if (entry.key == pawnKey)
+        {
+            return entry;
+        }
 
-    std::vector<Move> getAllPossibleMoves(Color player)
-    {
-        std::vector<Move> moves;
-        for (int i = 0; i < 8; i++)
+        entry = PawnEntry();
+        entry.key = pawnKey;
+        for (int c = 0; c < 2; ++c)
         {
-            for (int j = 0; j < 8; j++)
+            Color color = static_cast<Color>(c);
+            Color opponent = color == WHITE ? BLACK : WHITE;
+            int sign = color == WHITE ? 1 : -1;
+            Bitboard ownPawns = pieces[c][PAWN];
+            for (int j = 0; j < 8; ++j)
             {
-                if (board[i][j].color != player)
+                int count = popCount(ownPawns & columnBB(j));
+                // Kara za podwójne pionki
+                if (count > 1)
                 {
-                    continue;
+                    entry.structure -= sign * 50 * (count - 1);
                 }
-
-                Piece piece = board[i][j];
-                switch (piece.type)
+                // Kara za izolowane pionki
+                Bitboard neighbours = (j > 0 ? columnBB(j - 1) : 0) | (j < 7 ? columnBB(j + 1) : 0);
+                if (count > 0 && (ownPawns & neighbours) == 0)
                 {
-                    case PAWN:
-                    {
-                        int direction = (piece.color == WHITE) ? -1 : 1;
-                        int startRow = (piece.color == WHITE) ? 6 : 1;
-
-                        // Ruch o jedno pole do przodu
-                        if (isValidPosition(i + direction, j))
-                        {
-                            Move move(i, j, i + direction, j);
-                            if (isValidMove(move, player))
-                            {
-                                moves.push_back(move);
-                            }
-                        }
-
-                        // Ruch o dwa pola do przodu
-                        if (i == startRow && isValidPosition(i + 2 * direction, j))
-                        {
-                            Move move(i, j, i + 2 * direction, j);
-                            if (isValidMove(move, player))
-                            {
-                                moves.push_back(move);
-                            }
-                        }
+                    entry.structure -= sign * 40;
+                }
+            }
 
-                        // Bicie w lewo
-                        if (isValidPosition(i + direction, j - 1))
-                        {
-                            Move move(i, j, i + direction, j - 1);
-                            if (isValidMove(move, player))
-                            {
-                                moves.push_back(move);
-                            }
-                        }
+            Bitboard pawns = ownPawns;
+            while (pawns)
+            {
+                int square = popLsb(pawns);
+                int i = squareRow(square), j = squareColumn(square);
+                // Wolny pionek: brak pionków przeciwnika przed nim na tej samej i sąsiednich kolumnach
+                Bitboard rowsAhead = 0;
+                for (int k = i + (color == WHITE ? -1 : 1); k >= 0 && k < 8; k += (color == WHITE ? -1 : 1))
+                {
+                    rowsAhead |= rowBB(k);
+                }
+                Bitboard columns = columnBB(j) | ((columnBB(j) & ~COLUMN_A_BB) >> 1) |
+                                   ((columnBB(j) & ~COLUMN_H_BB) << 1);
+                if ((rowsAhead & columns & pieces[opponent][PAWN]) == 0)
+                {
+                    int rank = color == WHITE ? 7 - i : i;
+                    entry.structure += sign * (50 + rank * 20); // Bonus increases with rank
+                }
 
-                        // Bicie w prawo
-                        if (isValidPosition(i + direction, j + 1))
-                        {
-                            Move move(i, j, i + direction, j + 1);
-                            if (isValidMove(move, player))
-                            {
-                                moves.push_back(move);
-                            }
-                        }
-                        break;
-                    }
-                    case KNIGHT:
-                    {
-                        int knightMoves[8][2] = {{-2, -1},
-                                                 {-2, 1},
-                                                 {-1, -2},
-                                                 {-1, 2},
-                                                 {1,  -2},
-                                                 {1,  2},
-                                                 {2,  -1},
-                                                 {2,  1}};
-                        for (const auto &m: knightMoves)
-                        {
-                            int ni = i + m[0], nj = j + m[1];
-                            if (isValidPosition(ni, nj))
-                            {
-                                Move move(i, j, ni, nj);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                            }
-                        }
-                        break;
-                    }
-                    case BISHOP:
-                    {
-                        for (int d = -1; d <= 1; d += 2)
-                        {
-                            for (int e = -1; e <= 1; e += 2)
-                            {
-                                for (int k = 1; k < 8; k++)
-                                {
-                                    int ni = i + k * d, nj = j + k * e;
-                                    if (!isValidPosition(ni, nj))
-                                    {
-                                        break;
-                                    }
-                                    Move move(i, j, ni, nj);
-                                    if (isValidMove(move, player))
-                                    {
-                                        moves.push_back(move);
-                                    }
-                                    if (board[ni][nj] != EMPTY_PIECE)
-                                    {
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        break;
-                    }
-                    case ROOK:
-                    {
-                        for (int d = -1; d <= 1; d += 2)
-                        {
-                            for (int k = 1; k < 8; k++)
-                            {
-                                int ni = i + k * d, nj = j;
-                                if (!isValidPosition(ni, nj))
-                                {
-                                    break;
-                                }
-                                Move move(i, j, ni, nj);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                                if (board[ni][nj] != EMPTY_PIECE)
-                                {
-                                    break;
-                                }
-                            }
-                            for (int k = 1; k < 8; k++)
-                            {
-                                int ni = i, nj = j + k * d;
-                                if (!isValidPosition(ni, nj))
-                                {
-                                    break;
-                                }
-                                Move move(i, j, ni, nj);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                                if (board[ni][nj] != EMPTY_PIECE)
-                                {
-                                    break;
-                                }
-                            }
-                        }
-                        break;
-                    }
-                    case QUEEN:
-                    {
-                        for (int d = -1; d <= 1; d += 2)
-                        {
-                            for (int e = -1; e <= 1; e += 2)
-                            {
-                                for (int k = 1; k < 8; k++)
-                                {
-                                    int ni = i + k * d, nj = j + k * e;
-                                    if (!isValidPosition(ni, nj))
-                                    {
-                                        break;
-                                    }
-                                    Move move(i, j, ni, nj);
-                                    if (isValidMove(move, player))
-                                    {
-                                        moves.push_back(move);
-                                    }
-                                    if (board[ni][nj] != EMPTY_PIECE)
-                                    {
-                                        break;
-                                    }
-                                }
-                            }
-                            for (int k = 1; k < 8; k++)
-                            {
-                                int ni = i + k * d, nj = j;
-                                if (!isValidPosition(ni, nj))
-                                {
-                                    break;
-                                }
-                                Move move(i, j, ni, nj);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                                if (board[ni][nj] != EMPTY_PIECE)
-                                {
-                                    break;
-                                }
-                            }
-                            for (int k = 1; k < 8; k++)
-                            {
-                                int ni = i, nj = j + k * d;
-                                if (!isValidPosition(ni, nj))
-                                {
-                                    break;
-                                }
-                                Move move(i, j, ni, nj);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                                if (board[ni][nj] != EMPTY_PIECE)
-                                {
-                                    break;
-                                }
-                            }
-                        }
-                        break;
-                    }
-                    case KING:
-                    {
-                        for (int di = -1; di <= 1; di++)
-                        {
-                            for (int dj = -1; dj <= 1; dj++)
-                            {
-                                if (di == 0 && dj == 0)
-                                {
-                                    continue;
-                                }
-                                int ni = i + di, nj = j + dj;
-                                if (isValidPosition(ni, nj))
-                                {
-                                    Move move(i, j, ni, nj);
-                                    if (isValidMove(move, player))
-                                    {
-                                        moves.push_back(move);
-                                    }
-                                }
-                            }
-                        }
-                        // Roszada
-                        if (piece.color == WHITE && i == 7 && j == 4)
-                        {
-                            if (whiteCanCastleKingside)
-                            {
-                                Move move(7, 4, 7, 6);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                            }
-                            if (whiteCanCastleQueenside)
-                            {
-                                Move move(7, 4, 7, 2);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                            }
-                        }
-                        else if (piece.color == BLACK && i == 0 && j == 4)
-                        {
-                            if (blackCanCastleKingside)
-                            {
-                                Move move(0, 4, 0, 6);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                            }
-                            if (blackCanCastleQueenside)
-                            {
-                                Move move(0, 4, 0, 2);
-                                if (isValidMove(move, player))
-                                {
-                                    moves.push_back(move);
-                                }
-                            }
-                        }
-                        break;
-                    }
-                    default:
-                        break;
+                // Stronger bonus for advanced pawn ready for promotion
+                int advance = color == WHITE ? i : 7 - i;
+                if (advance <= 2)
+                {
+                    entry.promotion += sign * (PROMOTION_BONUS / (advance + 1));
                 }
             }
         }
-        return moves;
+        return entry;
+    }
+
+    // Osłona króla: własne pionki na trzech polach przed królem, zapamiętana we wpisie dla danego pola króla
+    int kingShield(PawnEntry &entry, Color color, int kingSquare)
+    {
+        if (entry.kingSquare[color] != kingSquare)
+        {
+            Bitboard front = pawnPush(squareBB(kingSquare) | (kingAttacks(kingSquare) & rowBB(squareRow(kingSquare))),
+                                      color);
+            entry.kingSquare[color] = kingSquare;
+            entry.shield[color] = 60 * popCount(front & pieces[color][PAWN]);
+        }
+        return entry.shield[color];
     }
 
     int evaluateBoard()
@@ -1526,328 +1353,162 @@ public:
         int score = 0;
         int mobilityScore = 0;
         int centerControl = 0;
-        int kingSafety = 0;
         int pawnStructure = 0;
         int pieceActivity = 0;
         int development = 0;
         int threatPenalty = 0; // New: penalty for pieces under threat
-        int passedPawnBonus = 0; // New: bonus for passed pawns
+        int kingPressure = 0;
+        // Składniki zależne od fazy gry, łączone na końcu proporcjonalnie do gamePhase
+        int middlegame = 0;
+        int endgame = 0;
 
-        // Określenie fazy gry
-        int totalMaterial = 0;
-        for (int i = 0; i < 8; i++)
+        bool isOpening = moveHistory.size() < 10;
+
+        // Mapy ataków obu stron liczone raz na ocenę; z nich wynikają mobilność, zagrożenia, możliwe bicia
+        // i nacisk na króla. Wszystkie składniki liczone są z punktu widzenia białych.
+        Bitboard occupancy = occupied[WHITE] | occupied[BLACK];
+        Bitboard attacked[2];
+        int mobility[2] = {0, 0};
+        for (int c = WHITE; c <= BLACK; ++c)
         {
-            for (int j = 0; j < 8; j++)
+            Color color = static_cast<Color>(c);
+            attacked[c] = pawnAttacksBB(pieces[c][PAWN], color);
+            if (pieces[c][KING])
             {
-                Piece piece = board[i][j];
-                if (piece == EMPTY_PIECE)
-                {
-                    continue;
-                }
-
-                int value = 0;
-                switch (piece.type)
+                attacked[c] |= kingAttacks(lsb(pieces[c][KING]));
+            }
+            for (int type = KNIGHT; type <= QUEEN; ++type)
+            {
+                Bitboard b = pieces[c][type];
+                while (b)
                 {
-                    case PAWN:
-                        value = PAWN_WEIGHT;
-                        break;
-                    case KNIGHT:
-                        value = KING_WEIGHT;
-                        break;
-                    case BISHOP:
-                        value = BISHOP_WEIGHT;
-                        break;
-                    case ROOK:
-                        value = ROOK_WEIGHT;
-                        break;
-                    case QUEEN:
-                        value = QUEEN_WEIGHT;
-                        break;
-                    case KING:
-                        value = KING_WEIGHT;
-                        break;
-                    default:
-                        value = 0;
-                        break;
+                    Bitboard targets = attacksFrom(Piece(static_cast<PieceType>(type), color), popLsb(b), occupancy);
+                    attacked[c] |= targets;
+                    mobility[c] += popCount(targets & ~occupied[c]);
                 }
-
-                totalMaterial += value;
             }
         }
 
-        bool isOpening = moveHistory.size() < 10;
-        bool isEndgame = totalMaterial < 2000;
-
         // Ocena figur i dodatkowych czynników
         int kingX[2] = {-1, -1}, kingY[2] = {-1, -1}; // Pozycje królów (0: białe, 1: czarne)
-        int pawnCount[2][8] = {{0}}; // Liczba pionków w każdej kolumnie
-        for (int i = 0; i < 8; i++)
+        Bitboard pieceSquares = occupancy;
+        while (pieceSquares)
         {
-            for (int j = 0; j < 8; j++)
-            {
-                Piece piece = board[i][j];
-                if (piece == EMPTY_PIECE)
-                {
-                    continue;
-                }
-
-                int value = 0;
-                switch (piece.type)
-                {
-                    case PAWN:
-                        value = PAWN_WEIGHT;
-                        break;
-                    case KNIGHT:
-                        value = KING_WEIGHT;
-                        break;
-                    case BISHOP:
-                        value = BISHOP_WEIGHT;
-                        break;
-                    case ROOK:
-                        value = ROOK_WEIGHT;
-                        break;
-                    case QUEEN:
-                        value = QUEEN_WEIGHT;
-                        break;
-                    case KING:
-                        value = KING_WEIGHT;
-                        break;
-                    default:
-                        value = 0;
-                }
-
-                // Kontrola centrum
-                if ((i == 3 || i == 4) && (j == 3 || j == 4))
-                {
-                    centerControl += (piece.type == PAWN ? 30 : 50);
-                }
-
-                // Bezpieczeństwo króla
-                if (piece.type == KING)
-                {
-                    kingX[piece.color] = i;
-                    kingY[piece.color] = j;
-
-                    // Bonus for pieces attacking squares near the enemy king
-                    for (int dx = -1; dx <= 1; dx++)
-                    {
-                        for (int dy = -1; dy <= 1; dy++)
-                        {
-                            int kx = kingX[1 - currentPlayer], ky = kingY[1 - currentPlayer];
-                            int ax = kx + dx, ay = ky + dy;
-                            if (isValidPosition(ax, ay) && board[ax][ay] != EMPTY_PIECE &&
-                                board[ax][ay].color == currentPlayer)
-                            {
-                                score += THREAT_KING_BONUS;
-                            }
-                        }
-                    }
+            int square = popLsb(pieceSquares);
+            int i = squareRow(square), j = squareColumn(square);
+            Piece piece = board[i][j];
+            int sign = piece.color == WHITE ? 1 : -1;
+            Color opponent = piece.color == WHITE ? BLACK : WHITE;
 
-                    if (!isEndgame)
-                    {
-                        // Kara za wczesne ruszanie królem
-                        if (piece.color == WHITE && i < 7 && isOpening)
-                        {
-                            kingSafety -= KING_SAFETY_BONUS;
-                        }
-                        else if (piece.color == BLACK && i > 0 && isOpening)
-                        {
-                            kingSafety -= KING_SAFETY_BONUS;
-                        }
-                        // Premia za roszadę
-                        if (piece.color == WHITE && (whiteCanCastleKingside || whiteCanCastleQueenside))
-                        {
-                            kingSafety += KING_SAFETY_BONUS;
-                        }
-                        else if (piece.color == BLACK && (blackCanCastleKingside || blackCanCastleQueenside))
-                        {
-                            kingSafety += KING_SAFETY_BONUS;
-                        }
-                    }
-                    else
-                    {
-                        // Endgame: Encourage king centralization
-                        int distToCenter = std::max(std::abs(i - 3.5), std::abs(j - 3.5));
-                        kingSafety -= distToCenter * 20; // Bonus for central king
-                    }
-                }
+            // Kontrola centrum
+            if ((i == 3 || i == 4) && (j == 3 || j == 4))
+            {
+                centerControl += sign * (piece.type == PAWN ? 30 : 50);
+            }
 
-                // Rozwój figur
-                if (isOpening && (piece.type == KNIGHT || piece.type == BISHOP))
-                {
-                    if (piece.color == WHITE && i == 7)
-                    {
-                        development -= 50; // Kara za nierozwinięte figury
-                    }
-                    else if (piece.color == BLACK && i == 0)
-                    {
-                        development -= 50;
-                    }
-                    else
-                    {
-                        development += 30;
-                    }
-                }
+            // Bezpieczeństwo króla
+            if (piece.type == KING)
+            {
+                kingX[piece.color] = i;
+                kingY[piece.color] = j;
 
-                // Aktywność figur
-                if (piece.type == ROOK)
-                {
-                    bool openFile = true;
-                    for (int k = 0; k < 8; ++k)
-                    {
-                        if (board[k][j].type == PAWN)
-                        {
-                            openFile = false;
-                        }
-                    }
-                    if (openFile)
-                    {
-                        pieceActivity += 60;
-                    } // Premia za wieżę na otwartej linii
-                    if (isEndgame && i == (piece.color == WHITE ? 1 : 6))
-                        pieceActivity += 50; // Bonus for rook on 7th rank
-                }
-                else if (piece.type == KNIGHT && (i == 3 || i == 4) && (j == 3 || j == 4))
+                // Kara za wczesne ruszanie królem
+                if (isOpening && i != (piece.color == WHITE ? 7 : 0))
                 {
-                    pieceActivity += 40; // Premia za skoczka w centrum
+                    middlegame -= sign * KING_SAFETY_BONUS;
                 }
-
-                // New: Passed pawn bonus
-                if (piece.type == PAWN)
+                // Premia za zachowane prawo do roszady
+                if (castlingRights & (piece.color == WHITE ? WHITE_CASTLING : BLACK_CASTLING))
                 {
-                    pawnCount[piece.color][j]++;
-                    bool isPassed = true;
-                    int direction = (piece.color == WHITE) ? -1 : 1;
-                    for (int k = i + direction; k >= 0 && k < 8; k += direction)
-                    {
-                        if ((j > 0 && board[k][j - 1].type == PAWN && board[k][j - 1].color != piece.color) ||
-                            (j < 7 && board[k][j + 1].type == PAWN && board[k][j + 1].color != piece.color) ||
-                            (board[k][j].type == PAWN && board[k][j].color != piece.color))
-                        {
-                            isPassed = false;
-                            break;
-                        }
-                    }
-                    if (isPassed)
-                    {
-                        int rank = piece.color == WHITE ? 7 - i : i;
-                        passedPawnBonus += 50 + rank * 20; // Bonus increases with rank
-                    }
-
-                    // Stronger bonus for advanced pawn ready for promotion
-                    int promotionRank = (piece.color == WHITE) ? 0 : 7;
-                    int advance = abs(i - promotionRank);
-                    if (advance <= 2)
-                    {
-                        score += (piece.color == WHITE ? 1 : -1) * (PROMOTION_BONUS / (advance + 1));
-                    }
+                    middlegame += sign * KING_SAFETY_BONUS;
                 }
+                // Endgame: Encourage king centralization
+                int distToCenter = std::max(std::abs(i - 3.5), std::abs(j - 3.5));
+                endgame -= sign * distToCenter * 20; // Bonus for central king
+            }
 
-                // Bonus za możliwość bicia
-                std::vector<Move> possibleCaptures = getAllPossibleMoves(piece.color);
-                for (const auto &move: possibleCaptures)
+            // Rozwój figur
+            if (isOpening && (piece.type == KNIGHT || piece.type == BISHOP))
+            {
+                if (i == (piece.color == WHITE ? 7 : 0))
                 {
-                    if (board[move.toX][move.toY] != EMPTY_PIECE && board[move.toX][move.toY].color != piece.color)
-                    {
-                        int captureValue = getCaptureValue(move);
-                        if (captureValue > 0)
-                        {
-                            pieceActivity += captureValue;
-                        } // Premia za możliwość bicia
-                    }
+                    development -= sign * 50; // Kara za nierozwinięte figury
                 }
-
-                // New: Threat penalty for high-value pieces
-                if (piece.type == QUEEN || piece.type == ROOK || piece.type == KNIGHT || piece.type == BISHOP)
+                else
                 {
-                    for (int x = 0; x < 8; ++x)
-                    {
-                        for (int y = 0; y < 8; ++y)
-                        {
-                            if (board[x][y] != EMPTY_PIECE && board[x][y].color != piece.color)
-                            {
-                                Move attackMove(x, y, i, j);
-                                if (isValidAttackMove(attackMove, board[x][y].color))
-                                {
-                                    int pieceValue = getCaptureValue({i, j, i, j});
-                                    threatPenalty -= pieceValue / 2; // Significant penalty
-                                }
-                            }
-                        }
-                    }
+                    development += sign * 30;
                 }
-
-                score += (piece.color == WHITE) ? value : -value;
             }
-        }
 
-        // Ocena struktury pionków
-        for (int j = 0; j < 8; ++j)
-        {
-            for (int c = 0; c < 2; ++c)
+            // Aktywność figur
+            if (piece.type == ROOK)
             {
-                Color color = static_cast<Color>(c);
-                // Kara za podwójne pionki
-                if (pawnCount[c][j] > 1)
-                {
-                    pawnStructure -= 50 * (pawnCount[c][j] - 1);
-                }
-                // Kara za izolowane pionki
-                bool isolated = true;
-                if (j > 0 && pawnCount[c][j - 1] > 0)
-                {
-                    isolated = false;
-                }
-                if (j < 7 && pawnCount[c][j + 1] > 0)
-                {
-                    isolated = false;
-                }
-                if (isolated && pawnCount[c][j] > 0)
+                bool openFile = ((pieces[WHITE][PAWN] | pieces[BLACK][PAWN]) & columnBB(j)) == 0;
+                if (openFile)
                 {
-                    pawnStructure -= 40;
-                }
-                pawnStructure = (color == WHITE) ? pawnStructure : -pawnStructure;
+                    pieceActivity += sign * 60;
+                } // Premia za wieżę na otwartej linii
+                if (i == (piece.color == WHITE ? 1 : 6))
+                    endgame += sign * 50; // Bonus for rook on 7th rank
+            }
+            else if (piece.type == KNIGHT && (i == 3 || i == 4) && (j == 3 || j == 4))
+            {
+                pieceActivity += sign * 40; // Premia za skoczka w centrum
             }
-        }
 
-        // Bezpieczeństwo króla: osłona pionkami
-        for (int c = 0; c < 2; ++c)
-        {
-            Color color = static_cast<Color>(c);
-            if (kingX[c] != -1)
+            if (piece.type != KING && (attacked[opponent] & squareBB(square)))
             {
-                int pawnShield = 0;
-                int direction = (color == WHITE) ? -1 : 1;
-                for (int dj = -1; dj <= 1; ++dj)
+                // Premia dla przeciwnika za możliwość bicia
+                int pieceValue = getPieceValue(piece.type);
+                pieceActivity -= sign * pieceValue;
+                // New: Threat penalty for high-value pieces
+                if (piece.type != PAWN)
                 {
-                    int nx = kingX[c] + direction, ny = kingY[c] + dj;
-                    if (isValidPosition(nx, ny) && board[nx][ny].type == PAWN && board[nx][ny].color == color)
-                    {
-                        pawnShield += 60;
-                    }
+                    threatPenalty -= sign * (pieceValue / 2);
                 }
-                kingSafety += (color == WHITE) ? pawnShield : -pawnShield;
             }
         }
 
-        // Mobilność
-        mobilityScore += getAllPossibleMoves(WHITE).size() * (isOpening ? 30 : 15);
-        mobilityScore -= getAllPossibleMoves(BLACK).size() * (isOpening ? 30 : 15);
+        // Materiał i premie pozycyjne utrzymywane przyrostowo
+        middlegame += mgScore[WHITE] - mgScore[BLACK];
+        endgame += egScore[WHITE] - egScore[BLACK];
 
-        // Reward for giving check to opponent, bigger for mate
-        if (isInCheck(currentPlayer == WHITE ? BLACK : WHITE))
+        // Struktura pionków z tabeli pionków
+        PawnEntry &pawnEntry = probePawnStructure();
+        pawnStructure += pawnEntry.structure;
+
+        // Bezpieczeństwo króla: osłona pionkami i nacisk przeciwnika na pola wokół króla
+        for (int c = 0; c < 2; ++c)
         {
-            score += CHECK_BONUS;
-            // If opponent has no legal moves: checkmate!
-            if (getAllPossibleMoves(currentPlayer == WHITE ? BLACK : WHITE).empty())
+            Color color = static_cast<Color>(c);
+            int sign = color == WHITE ? 1 : -1;
+            if (kingX[c] != -1)
             {
-                score += CHECKMATE_BONUS;
+                middlegame += sign * kingShield(pawnEntry, color, squareIndex(kingX[c], kingY[c]));
+
+                Bitboard kingZone = kingAttacks(squareIndex(kingX[c], kingY[c]));
+                kingPressure -= sign * THREAT_KING_BONUS * popCount(kingZone & attacked[1 - c]) / 8;
             }
         }
-        // Penalize being in check
-        if (isInCheck(currentPlayer))
+
+        // Mobilność: pola osiągalne dla skoczków, gońców, wież i hetmanów
+        mobilityScore += (mobility[WHITE] - mobility[BLACK]) * (isOpening ? 30 : 15);
+
+        // Centrum, rozwój i nacisk na króla liczą się głównie w środkowej grze, pionki blisko promocji
+        // w końcówce. Mobilność, aktywność figur, zagrożenia i struktura pionków mają w obu fazach tę samą wagę.
+        int common = mobilityScore + pawnStructure + pieceActivity + threatPenalty;
+        middlegame += common + centerControl + development + kingPressure + pawnEntry.promotion / 2;
+        endgame += common + centerControl / 2 + kingPressure / 2 + pawnEntry.promotion;
+
+        // Płynne przejście od oceny środkowej gry do końcówki zamiast skoku przy progu materiału
+        int phase = std::min(gamePhase, MAX_PHASE);
+        score += (middlegame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE;
+
+        // Szach dla strony na posunięciu jest premią dla przeciwnika
+        Color opponent = currentPlayer == WHITE ? BLACK : WHITE;
+        if (pieces[currentPlayer][KING] & attacked[opponent])
         {
-            score -= CHECK_BONUS;
+            score += currentPlayer == WHITE ? -CHECK_BONUS : CHECK_BONUS;
         }
 
         // Heavier penalty for repeating positions
@@ -1871,456 +1532,662 @@ public:
             score = -20000;
         }
 
-        return score + mobilityScore + centerControl + kingSafety + pawnStructure + pieceActivity + development +
-               threatPenalty + passedPawnBonus;
+        // Kara za trzykrotne powtórzenie zostaje tuż poza przedziałem wyników matowych - wyszukiwanie
+        // (okna aspiracji, przycinanie, losowanie ruchu) nie może jej wziąć za mata
+        int limit = CHECKMATE_BONUS - MAX_PLY - 1;
+        return std::max(-limit, std::min(score, limit));
+    }
+
+    // Ocena z punktu widzenia strony na posunięciu (evaluateBoard liczy z punktu widzenia białych)
+    int evaluate()
+    {
+        int score = evaluateBoard();
+        return currentPlayer == WHITE ? score : -score;
     }
 
-    // New: Quiescence search to evaluate captures beyond depth limit
-    int quiescenceSearch(int alpha, int beta, bool maximizingPlayer, int maxDepth)
+    // Przerwanie wyszukiwania po przekroczeniu limitu czasu; zegar sprawdzany co 256 węzłów
+    bool searchTimeUp()
     {
-        int standPat = evaluateBoard();
-        if (maxDepth <= 0)
+        if (!searchStopped && (++searchNodes & 255) == 0 && std::chrono::steady_clock::now() >= searchDeadline)
         {
-            return standPat;
+            searchStopped = true;
         }
-        if (maximizingPlayer)
+        return searchStopped;
+    }
+
+    // Przeszukiwanie bić i ucieczek z szacha, żeby ocena nie zapadała w środku wymiany
+    int quiescenceSearch(int alpha, int beta, int maxDepth)
+    {
+        if (searchTimeUp())
         {
-            if (standPat >= beta)
+            return 0;
+        }
+        if (maxDepth <= 0 || searchPly >= MAX_PLY - 1)
+        {
+            return evaluate();
+        }
+
+        // W szachu nie ma oceny "stojąc w miejscu" - przeszukiwane są wszystkie ucieczki, a ich brak to mat.
+        // Poza szachem: bicia i promocje, a na pierwszym poziomie także ciche ruchy dające szacha.
+        bool inCheck = isInCheck(currentPlayer);
+        int standPat = 0;
+        MoveList &qsearchMoves = moveStack[searchPly];
+        if (inCheck)
+        {
+            getAllPossibleMoves(currentPlayer, qsearchMoves);
+            if (qsearchMoves.empty())
             {
-                return beta;
+                return -CHECKMATE_BONUS + searchPly;
             }
-            alpha = std::max(alpha, standPat);
         }
         else
         {
-            if (standPat <= alpha)
+            standPat = evaluate();
+            if (standPat >= beta)
             {
-                return alpha;
+                return beta;
             }
-            beta = std::min(beta, standPat);
+            alpha = std::max(alpha, standPat);
+            getCaptureMoves(currentPlayer, qsearchMoves, maxDepth == QUIESCENCE_DEPTH);
         }
 
-        std::vector<Move> captureMoves;
-        Color player = maximizingPlayer ? currentPlayer : (currentPlayer == WHITE ? BLACK : WHITE);
-        for (int i = 0; i < 8; i++)
+        for (ScoredMove &move: qsearchMoves)
         {
-            for (int j = 0; j < 8; j++)
+            move.score = isTactical(move) ? mvvLva(move) : 0;
+        }
+        std::sort(qsearchMoves.begin(), qsearchMoves.end(), [](const ScoredMove &a, const ScoredMove &b)
+        {
+            return a.score > b.score;
+        });
+
+        for (PackedMove move: qsearchMoves)
+        {
+            if (!inCheck)
             {
-                if (board[i][j].color != player)
+                // Delta pruning: nawet zdobyty materiał z zapasem nie podniesie alpha
+                if (standPat + materialGain(move) + DELTA_MARGIN <= alpha)
                 {
                     continue;
                 }
-                std::vector<Move> moves = getAllPossibleMoves(player);
-                for (const auto &move: moves)
+                // Ruchy tracące materiał w wymianie pomijamy
+                if (see(move) < 0)
                 {
-                    if (board[move.toX][move.toY] != EMPTY_PIECE ||
-                        (board[i][j].type == PAWN && move.toX == enPassantTargetX && move.toY == enPassantTargetY))
-                    {
-                        captureMoves.push_back(move);
-                    }
+                    continue;
                 }
             }
+            doMove(move);
+            int score = -quiescenceSearch(-beta, -alpha, maxDepth - 1);
+            undoMove();
+
+            if (score >= beta)
+            {
+                return beta;
+            }
+            alpha = std::max(alpha, score);
         }
 
-        std::sort(captureMoves.begin(), captureMoves.end(), [this](const Move &a, const Move &b)
+        return alpha;
+    }
+
+    // Wynik poza oknem (alpha, beta) jest tylko ograniczeniem prawdziwej wartości pozycji
+    static Bound boundType(int value, int alpha, int beta)
+    {
+        if (value <= alpha)
         {
-            return getCaptureValue(a) > getCaptureValue(b);
-        });
+            return BOUND_UPPER;
+        }
+        return value >= beta ? BOUND_LOWER : BOUND_EXACT;
+    }
 
-        for (const Move &move: captureMoves)
+    // Wynik matowy liczony jest od korzenia, a wpis tabeli może trafić na inny ply albo do kolejnego
+    // wyszukiwania, więc w tabeli zapisywana jest odległość do mata od bieżącego węzła
+    int scoreToTable(int score) const
+    {
+        if (score >= CHECKMATE_BONUS - MAX_PLY)
         {
-            GameState state = makeTemporaryMove(move);
-            int score;
-            if (board[move.toX][move.toY].type == PAWN && (move.toX == 0 || move.toX == 7))
+            return score + searchPly;
+        }
+        if (score <= -CHECKMATE_BONUS + MAX_PLY)
+        {
+            return score - searchPly;
+        }
+        return score;
+    }
+
+    int scoreFromTable(int score) const
+    {
+        if (score >= CHECKMATE_BONUS - MAX_PLY)
+        {
+            return score - searchPly;
+        }
+        if (score <= -CHECKMATE_BONUS + MAX_PLY)
+        {
+            return score + searchPly;
+        }
+        return score;
+    }
+
+    // Bicia i promocje do hetmana - ruchy zmieniające materiał
+    bool isTactical(const PackedMove &move) const
+    {
+        return isCapture(move) || (move.flag() == PROMOTION_MOVE && move.promotion() == QUEEN);
+    }
+
+    void clearMoveOrdering()
+    {
+        std::fill(&killerMoves[0][0], &killerMoves[0][0] + MAX_PLY * 2, PackedMove());
+        std::fill(&historyTable[0][0][0], &historyTable[0][0][0] + 2 * 64 * 64, 0);
+        std::fill(&counterMoves[0][0], &counterMoves[0][0] + 64 * 64, PackedMove());
+    }
+
+    // Przed nowym wyszukiwaniem: killery dotyczą innych pozycji na tych samych ply, a historia słabnie o połowę
+    void ageMoveOrdering()
+    {
+        std::fill(&killerMoves[0][0], &killerMoves[0][0] + MAX_PLY * 2, PackedMove());
+        for (int *entry = &historyTable[0][0][0]; entry != &historyTable[0][0][0] + 2 * 64 * 64; ++entry)
+        {
+            *entry /= 2;
+        }
+    }
+
+    // Aktualizacja z "grawitacją": im bliżej granicy MAX_HISTORY, tym mniej zmienia ją kolejna premia,
+    // więc wartości nie rosną bez końca, a ruchy przestające działać szybko tracą pozycję
+    void updateHistory(const PackedMove &move, int bonus)
+    {
+        int &entry = historyTable[currentPlayer][move.from()][move.to()];
+        entry += bonus - entry * std::abs(bonus) / MAX_HISTORY;
+    }
+
+    // Pusty ruch ma sens, gdy strona na posunięciu ma figurę inną niż pionek i król, a poprzedni ruch
+    // nie był pusty (szach sprawdza wywołujący)
+    bool canTryNullMove() const
+    {
+        Bitboard nonPawnPieces = pieces[currentPlayer][KNIGHT] | pieces[currentPlayer][BISHOP] |
+                                 pieces[currentPlayer][ROOK] | pieces[currentPlayer][QUEEN];
+        bool afterNullMove = !undoStack.empty() && undoStack.back().move.isNull();
+        return nonPawnPieces != 0 && !afterNullMove;
+    }
+
+    // Ruch przeciwnika, który doprowadził do bieżącej pozycji (pusty na początku partii)
+    PackedMove previousMove() const
+    {
+        return undoStack.empty() ? PackedMove() : undoStack.back().move;
+    }
+
+    PackedMove counterMove() const
+    {
+        PackedMove previous = previousMove();
+        return previous.isNull() ? PackedMove() : counterMoves[previous.from()][previous.to()];
+    }
+
+    // Ruch cichy, który spowodował odcięcie, trafia do killerów, historii i tabeli odpowiedzi,
+    // a wcześniej przeszukane ruchy ciche dostają karę w historii
+    void updateQuietStats(const PackedMove &move, int depth, const PackedMove *quietsSearched, int quietCount)
+    {
+        if (killerMoves[searchPly][0] != move)
+        {
+            killerMoves[searchPly][1] = killerMoves[searchPly][0];
+            killerMoves[searchPly][0] = move;
+        }
+        // Unarny plus daje kopię stałej: std::min bierze argumenty przez referencję, a MAX_HISTORY
+        // nie ma definicji poza klasą (C++14), więc bez optymalizacji konsolidacja by się nie udała
+        int bonus = std::min(32 * depth * depth, +MAX_HISTORY);
+        updateHistory(move, bonus);
+        for (int i = 0; i < quietCount; ++i)
+        {
+            updateHistory(quietsSearched[i], -bonus);
+        }
+        PackedMove previous = previousMove();
+        if (!previous.isNull())
+        {
+            counterMoves[previous.from()][previous.to()] = move;
+        }
+    }
+
+    // Ocena ruchu cichego do sortowania
+    int quietScore(const PackedMove &move) const
+    {
+        int score = historyTable[currentPlayer][move.from()][move.to()];
+        if (moveHistory.size() < 10)
+        {
+            // Rozwój figur
+            Piece piece = pieceOn(move.from());
+            if (piece.type == KNIGHT || piece.type == BISHOP)
             {
-                score = getBestPromotionEval(move, maxDepth - 1, alpha, beta, !maximizingPlayer);
+                score += 50;
             }
-            else
+            // Ostrożność z hetmanem
+            if (piece.type == QUEEN)
             {
-                score = quiescenceSearch(alpha, beta, !maximizingPlayer, maxDepth - 1);
+                score -= 30;
             }
-            undoMove(state);
+        }
+        return score;
+    }
 
-            if (maximizingPlayer)
+    // Kolejny ruch do przeszukania albo pusty ruch, gdy lista się skończyła. Bicia oceniane są dopiero
+    // po ruchu z tabeli, a ruchy ciche dopiero po biciach i ruchach killer, więc wczesne odcięcie
+    // pomija ocenę pozostałych ruchów. Żaden ruch nie jest przy tym wykonywany na próbę.
+    PackedMove nextMove(MovePicker &picker)
+    {
+        MoveList &moves = picker.moves;
+        while (true)
+        {
+            switch (picker.stage)
             {
-                alpha = std::max(alpha, score);
-                if (alpha >= beta)
-                {
+                case PICK_TT_MOVE:
+                    picker.stage = PICK_INIT_CAPTURES;
+                    if (picker.takeMove(picker.ttMove, moves.size()))
+                    {
+                        return picker.ttMove;
+                    }
                     break;
-                }
-            }
-            else
-            {
-                beta = std::min(beta, score);
-                if (beta <= alpha)
+                case PICK_INIT_CAPTURES:
                 {
+                    // Bicia według MVV-LVA; tracące materiał (ujemne SEE) trafiają na koniec listy
+                    for (int i = picker.current; i < moves.size(); ++i)
+                    {
+                        if (isTactical(moves[i]))
+                        {
+                            int exchange = see(moves[i]);
+                            moves[i].score = exchange >= 0 ? mvvLva(moves[i]) : exchange;
+                        }
+                    }
+                    ScoredMove *goodEnd = std::partition(moves.begin() + picker.current, moves.end(),
+                                                         [this](const ScoredMove &move)
+                                                         {
+                                                             return isTactical(move) && move.score >= 0;
+                                                         });
+                    ScoredMove *quietEnd = std::partition(goodEnd, moves.end(), [this](const ScoredMove &move)
+                    {
+                        return !isTactical(move);
+                    });
+                    picker.goodCapturesEnd = static_cast<int>(goodEnd - moves.begin());
+                    picker.quietsEnd = static_cast<int>(quietEnd - moves.begin());
+                    picker.stage = PICK_GOOD_CAPTURES;
                     break;
                 }
+                case PICK_GOOD_CAPTURES:
+                    if (picker.current < picker.goodCapturesEnd)
+                    {
+                        return picker.pickBest(picker.goodCapturesEnd);
+                    }
+                    picker.stage = PICK_REFUTATIONS;
+                    break;
+                case PICK_REFUTATIONS:
+                    // Ruch już zwrócony (np. killer równy odpowiedzi) nie leży w obszarze ruchów cichych
+                    while (picker.refutationIndex < MovePicker::REFUTATION_COUNT)
+                    {
+                        PackedMove refutation = picker.refutations[picker.refutationIndex++];
+                        if (picker.takeMove(refutation, picker.quietsEnd))
+                        {
+                            return refutation;
+                        }
+                    }
+                    picker.stage = PICK_INIT_QUIETS;
+                    break;
+                case PICK_INIT_QUIETS:
+                    for (int i = picker.current; i < picker.quietsEnd; ++i)
+                    {
+                        moves[i].score = quietScore(moves[i]);
+                    }
+                    picker.stage = PICK_QUIETS;
+                    break;
+                case PICK_QUIETS:
+                    if (picker.current < picker.quietsEnd)
+                    {
+                        return picker.pickBest(picker.quietsEnd);
+                    }
+                    picker.stage = PICK_BAD_CAPTURES;
+                    break;
+                case PICK_BAD_CAPTURES:
+                    if (picker.current < moves.size())
+                    {
+                        return picker.pickBest(moves.size());
+                    }
+                    picker.stage = PICK_DONE;
+                    break;
+                case PICK_DONE:
+                    return PackedMove();
             }
         }
-
-        return maximizingPlayer ? alpha : beta;
     }
 
-    int minimax(int depth, int alpha, int beta, bool maximizingPlayer)
+    // Negamax z przeszukiwaniem głównego wariantu (PVS): pierwszy ruch dostaje pełne okno, pozostałe zerowe okno,
+    // a ponowne pełne przeszukanie tylko wtedy, gdy wynik wpadnie do wnętrza okna. Wynik z punktu widzenia
+    // strony na posunięciu.
+    int negamax(int depth, int alpha, int beta)
     {
         if (depth == 0)
         {
-            return quiescenceSearch(alpha, beta, maximizingPlayer, 4); // Quiescence search up to depth 4
+            return quiescenceSearch(alpha, beta, QUIESCENCE_DEPTH);
+        }
+        if (searchTimeUp())
+        {
+            return 0;
+        }
+        if (searchPly >= MAX_PLY - 1)
+        {
+            return evaluate();
         }
 
-        if (isGameOver())
+        // Wartość z tabeli wolno użyć tylko wtedy, gdy jej rodzaj pozwala na odcięcie w obecnym oknie
+        uint64_t positionKey = hashKey;
+        int originalAlpha = alpha;
+        PackedMove hashMove;
+        TranspositionEntry ttEntry;
+        if (transpositionTable.probe(positionKey, ttEntry))
         {
-            int eval = evaluateBoard();
-            if (isInCheck(maximizingPlayer ? currentPlayer : (currentPlayer == WHITE ? BLACK : WHITE)))
+            hashMove = ttEntry.bestMove;
+            int ttValue = scoreFromTable(ttEntry.value);
+            if (ttEntry.depth >= depth &&
+                (ttEntry.bound() == BOUND_EXACT || (ttEntry.bound() == BOUND_LOWER && ttValue >= beta) ||
+                 (ttEntry.bound() == BOUND_UPPER && ttValue <= alpha)))
             {
-                eval -= 500;
+                return ttValue;
             }
-            return eval;
         }
 
-        std::string positionKey = getPositionKey();
-        auto ttEntry = transpositionTable.find(positionKey);
-        if (ttEntry != transpositionTable.end() && ttEntry->second.depth >= depth)
+        bool inCheck = isInCheck(currentPlayer);
+        bool pvNode = beta - alpha > 1;
+        // Ocena statyczna dla przycinania; w szachu i w węzłach PV nie jest potrzebna
+        bool canPrune = !pvNode && !inCheck;
+        int staticEval = canPrune ? evaluate() : 0;
+        bool mateBounds = std::abs(alpha) >= CHECKMATE_BONUS - MAX_PLY || std::abs(beta) >= CHECKMATE_BONUS - MAX_PLY;
+
+        // Reverse futility: ocena statyczna z zapasem na każdy ply powyżej beta - przeciwnik nie zdąży
+        // odrobić straty
+        if (canPrune && !mateBounds && depth <= pruningMargins.reverseFutilityDepth &&
+            staticEval - pruningMargins.reverseFutility * depth >= beta)
         {
-            return ttEntry->second.value;
+            return staticEval - pruningMargins.reverseFutility * depth;
         }
 
-        std::vector<Move> moves = getAllPossibleMoves(
-                maximizingPlayer ? currentPlayer : (currentPlayer == WHITE ? BLACK : WHITE));
-        if (moves.empty())
+        // Razoring: ocena daleko poniżej alpha - jeśli bicia nie poprawiają wyniku, ruchy ciche też nie pomogą
+        if (canPrune && !mateBounds && depth <= pruningMargins.razoringDepth &&
+            staticEval + pruningMargins.razoring * depth < alpha)
         {
-            if (isInCheck(maximizingPlayer ? currentPlayer : (currentPlayer == WHITE ? BLACK : WHITE)))
+            int razorScore = quiescenceSearch(alpha, alpha + 1, QUIESCENCE_DEPTH);
+            if (searchStopped)
+            {
+                return 0;
+            }
+            if (razorScore <= alpha)
             {
-                return maximizingPlayer ? -CHECKMATE_BONUS + depth : CHECKMATE_BONUS - depth;
+                return razorScore;
             }
-            return 0;
         }
 
-        // Sortowanie ruchów
-        std::sort(moves.begin(), moves.end(), [this, depth](const Move &a, const Move &b)
-        {
-            int scoreA = getCaptureValue(a) * CAPTURE_BONUS_MULTIPLIER;
-            int scoreB = getCaptureValue(b) * CAPTURE_BONUS_MULTIPLIER;
-            GameState stateA = makeTemporaryMove(a);
-            bool isCheckA = isInCheck(currentPlayer);
-            bool isMateA = isCheckA && getAllPossibleMoves(currentPlayer).empty();
-            undoMove(stateA);
-            scoreA += isMateA ? 999999 : (isCheckA ? 800 : 0);
-            GameState stateB = makeTemporaryMove(b);
-            bool isCheckB = isInCheck(currentPlayer);
-            bool isMateB = isCheckB && getAllPossibleMoves(currentPlayer).empty();
-            undoMove(stateB);
-            scoreB += isMateB ? 999999 : (isCheckB ? 800 : 0);
-            // Rozwój figur
-            if (moveHistory.size() < 10)
+        // Null move pruning: jeśli nawet po oddaniu ruchu płytsze wyszukiwanie daje wynik >= beta, pozycja
+        // jest na tyle dobra, że pełne wyszukiwanie też dałoby odcięcie. Nie dotyczy szacha, dwóch pustych
+        // ruchów z rzędu i pozycji z samymi pionkami, gdzie zugzwang jest częsty.
+        if (depth >= 2 && canPrune && !nullMoveVerification && canTryNullMove() && staticEval >= beta)
+        {
+            int reduction = NULL_MOVE_REDUCTION + depth / 4;
+            doNullMove();
+            int nullScore = -negamax(std::max(depth - 1 - reduction, 0), -beta, -beta + 1);
+            undoNullMove();
+            if (searchStopped)
             {
-                Piece pieceA = board[a.fromX][a.fromY];
-                Piece pieceB = board[b.fromX][b.fromY];
-                if (pieceA.type == KNIGHT || pieceA.type == BISHOP)
-                {
-                    scoreA += 50;
-                }
-                if (pieceB.type == KNIGHT || pieceB.type == BISHOP)
+                return 0;
+            }
+            if (nullScore >= beta)
+            {
+                // Wynik matowy po pustym ruchu nie jest wiarygodny
+                nullScore = std::min(nullScore, CHECKMATE_BONUS - MAX_PLY - 1);
+                if (depth < NULL_MOVE_VERIFY_DEPTH)
                 {
-                    scoreB += 50;
+                    return nullScore;
                 }
-                // Ostrożność z hetmanem
-                if (pieceA.type == QUEEN)
+                // Weryfikacja na dużej głębokości: zwykłe, zredukowane wyszukiwanie bez pustych ruchów
+                // chroni przed zugzwangiem
+                nullMoveVerification = true;
+                int verifyScore = negamax(depth - reduction, beta - 1, beta);
+                nullMoveVerification = false;
+                if (searchStopped)
                 {
-                    scoreA -= 30;
+                    return 0;
                 }
-                if (pieceB.type == QUEEN)
+                if (verifyScore >= beta)
                 {
-                    scoreB -= 30;
+                    return nullScore;
                 }
             }
-            // Killer moves
-            if (a == (killerMoves[depth][0]) || a == killerMoves[depth][1])
-            {
-                scoreA += 200;
-            }
-            if (b == killerMoves[depth][0] || b == killerMoves[depth][1])
-            {
-                scoreB += 200;
-            }
-
-            return scoreA > scoreB;
-        });
+        }
 
-        if (maximizingPlayer)
+        MoveList &moves = moveStack[searchPly];
+        getAllPossibleMoves(currentPlayer, moves);
+        if (moves.empty())
         {
-            int maxEval = INT_MIN;
-            Move bestMove;
-            for (const Move &move: moves)
+            // Szybszy mat jest lepszy dla strony matującej
+            return inCheck ? -CHECKMATE_BONUS + searchPly : 0;
+        }
+
+        // Najlepszy ruch zapisany w tabeli sprawdzamy jako pierwszy
+        MovePicker picker(moves, hashMove, killerMoves[searchPly][0], killerMoves[searchPly][1], counterMove());
+        int bestScore = -INFINITE_SCORE;
+        PackedMove bestMove;
+        int movesSearched = 0;
+        PackedMove quietsSearched[MoveList::MAX_MOVES];
+        int quietCount = 0;
+        // Futility pruning: przy ocenie z zapasem poniżej alpha ruchy ciche (poza pierwszym i dającymi szacha)
+        // nie mają szans jej podnieść
+        bool futile = canPrune && !mateBounds && depth <= pruningMargins.futilityDepth &&
+                      staticEval + pruningMargins.futility * depth <= alpha;
+        for (PackedMove move = nextMove(picker); !move.isNull(); move = nextMove(picker))
+        {
+            // Późne ruchy ciche (po biciach, killerach i odpowiedzi) mogą dostać redukcję
+            bool lateQuiet = picker.stage == PICK_QUIETS && depth >= LMR_MIN_DEPTH && !inCheck;
+            int history = historyTable[currentPlayer][move.from()][move.to()];
+            // Rodzaj ruchu sprawdzany przed doMove - po ruchu pole docelowe jest już zajęte
+            bool quiet = !isTactical(move);
+            doMove(move);
+            bool givesCheck = isInCheck(currentPlayer);
+            if (futile && movesSearched > 0 && quiet && !givesCheck)
+            {
+                undoMove();
+                continue;
+            }
+            // Przedłużenie o jeden ply za szach, w limicie przedłużeń na ścieżce od korzenia
+            int extension = givesCheck && checkExtensions < MAX_CHECK_EXTENSIONS ? 1 : 0;
+            int newDepth = depth - 1 + extension;
+            checkExtensions += extension;
+            int score;
+            if (movesSearched++ == 0)
             {
-                GameState state = makeTemporaryMove(move);
-                int eval = (board[move.toX][move.toY].type == PAWN && (move.toX == 0 || move.toX == 7))
-                           ? getBestPromotionEval(move, depth - 1, alpha, beta, false) : minimax(depth - 1, alpha, beta,
-                                                                                                 false);
-                undoMove(state);
-
-                // New: Bonus for safe captures
-                if (getCaptureValue(move) > 0)
+                score = -negamax(newDepth, -beta, -alpha);
+            }
+            else
+            {
+                // Late move reductions: mniej dla ruchów z dobrą historią i w węzłach PV, bez redukcji
+                // dla ruchów dających szacha. Zredukowany wynik powyżej alpha jest sprawdzany na pełnej głębokości.
+                int reduction = 0;
+                if (lateQuiet && !givesCheck)
                 {
-                    bool isSafe = true;
-                    GameState tempState = makeTemporaryMove(move);
-                    for (int x = 0; x < 8; ++x)
-                    {
-                        for (int y = 0; y < 8; ++y)
-                        {
-                            if (board[x][y] != EMPTY_PIECE && board[x][y].color != currentPlayer)
-                            {
-                                Move attackMove(x, y, move.toX, move.toY);
-                                if (isValidAttackMove(attackMove, board[x][y].color))
-                                {
-                                    isSafe = false;
-                                    break;
-                                }
-                            }
-                        }
-                        if (!isSafe)
-                        {
-                            break;
-                        }
-                    }
-                    undoMove(tempState);
-                    if (isSafe)
-                    {
-                        eval += SAFE_CAPTURE_BONUS;
-                    } // Bonus for safe captures
+                    reduction = lateMoveReduction(depth, movesSearched) - history / LMR_HISTORY_DIVISOR -
+                                (pvNode ? 1 : 0);
+                    reduction = std::max(0, std::min(reduction, depth - 2));
                 }
-
-                if (eval > maxEval)
+                score = -negamax(newDepth - reduction, -alpha - 1, -alpha);
+                if (reduction > 0 && score > alpha)
                 {
-                    maxEval = eval;
-                    bestMove = move;
+                    score = -negamax(newDepth, -alpha - 1, -alpha);
                 }
-                alpha = std::max(alpha, eval);
-                if (beta <= alpha)
+                if (score > alpha && score < beta)
                 {
-                    if (getCaptureValue(move) == 0)
-                    {
-                        killerMoves[depth][1] = killerMoves[depth][0];
-                        killerMoves[depth][0] = move;
-                    }
-                    break;
+                    score = -negamax(newDepth, -beta, -alpha);
                 }
             }
-
-            int before = materialSum();
-            GameState state = makeTemporaryMove(bestMove);
-            int after = materialSum();
-            undoMove(state);
-            if (after > before)
+            checkExtensions -= extension;
+            undoMove();
+            if (searchStopped)
             {
-                maxEval += (after - before) * 10;
-            } // Or more
+                return 0;
+            }
 
-            // Zapis do tabeli transpozycji
-            transpositionTable[positionKey] = {maxEval, depth, bestMove};
-            return maxEval;
-        }
-        else
-        {
-            int minEval = INT_MAX;
-            Move bestMove;
-            for (const Move &move: moves)
+            if (score > bestScore)
             {
-                GameState state = makeTemporaryMove(move);
-                int eval = (board[move.toX][move.toY].type == PAWN && (move.toX == 0 || move.toX == 7))
-                           ? getBestPromotionEval(move, depth - 1, alpha, beta, true) : minimax(depth - 1, alpha, beta,
-                                                                                                true);
-                undoMove(state);
-
-                // New: Penalty for moves exposing pieces
-                if (getCaptureValue(move) == 0)
+                bestScore = score;
+                bestMove = move;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta)
+            {
+                if (quiet)
                 {
-                    GameState tempState = makeTemporaryMove(move);
-                    for (int x = 0; x < 8; ++x)
-                    {
-                        for (int y = 0; y < 8; ++y)
-                        {
-                            if (board[x][y].type == QUEEN && board[x][y].color == currentPlayer)
-                            {
-                                for (int ax = 0; ax < 8; ++ax)
-                                {
-                                    for (int ay = 0; ay < 8; ++ay)
-                                    {
-                                        if (board[ax][ay] != EMPTY_PIECE && board[ax][ay].color != currentPlayer)
-                                        {
-                                            Move attackMove(ax, ay, x, y);
-                                            if (isValidAttackMove(attackMove, board[ax][ay].color))
-                                            {
-                                                eval -= 4 * QUEEN_WEIGHT; // Or even 10x for extreme caution!
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                            else if (board[x][y] != EMPTY_PIECE && board[x][y].color != currentPlayer)
-                            {
-                                Move attackMove(x, y, move.toX, move.toY);
-                                if (isValidAttackMove(attackMove, board[x][y].color))
-                                {
-                                    int pieceValue = getCaptureValue({move.toX, move.toY, move.toX, move.toY});
-                                    eval -= pieceValue / 2;
-                                }
-                            }
-                        }
-                    }
-                    undoMove(tempState);
+                    updateQuietStats(move, depth, quietsSearched, quietCount);
                 }
+                break;
+            }
+            if (quiet)
+            {
+                quietsSearched[quietCount++] = move;
+            }
+        }
+
+        // Zapis do tabeli transpozycji
+        transpositionTable.store(positionKey, scoreToTable(bestScore), depth, boundType(bestScore, originalAlpha, beta),
+                                 bestMove);
+        return bestScore;
+    }
 
-                if (eval < minEval)
+    // Korzeń wyszukiwania: ta sama logika PVS co w negamax, z jedną różnicą. Zerowe okno stoi
+    // NEAR_BEST_MARGIN punktów poniżej najlepszego wyniku, więc ruchy prawie równe najlepszemu są przeszukiwane
+    // ponownie z pełnym oknem i dostają dokładną ocenę. Trafiają one do nearBest, z którego losowany jest ruch.
+    int searchRoot(int depth, int alpha, int beta, PackedMove &bestMove, std::vector<ScoredMove> &nearBest)
+    {
+        nearBest.clear();
+        MoveList &moves = moveStack[searchPly];
+        getAllPossibleMoves(currentPlayer, moves);
+        MovePicker picker(moves, bestMove, PackedMove(), PackedMove(), PackedMove());
+        int bestScore = -INFINITE_SCORE;
+        int movesSearched = 0;
+        for (PackedMove move = nextMove(picker); !move.isNull(); move = nextMove(picker))
+        {
+            doMove(move);
+            int score;
+            if (movesSearched++ == 0)
+            {
+                score = -negamax(depth - 1, -beta, -alpha);
+            }
+            else
+            {
+                int floor = std::max(alpha, bestScore - NEAR_BEST_MARGIN - 1);
+                score = -negamax(depth - 1, -floor - 1, -floor);
+                if (score > floor && score < beta)
                 {
-                    minEval = eval;
-                    bestMove = move;
+                    score = -negamax(depth - 1, -beta, -floor);
                 }
-                beta = std::min(beta, eval);
-                if (beta <= alpha)
+            }
+            undoMove();
+            if (searchStopped)
+            {
+                return 0;
+            }
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestMove = move;
+                nearBest.erase(std::remove_if(nearBest.begin(), nearBest.end(), [bestScore](const ScoredMove &other)
                 {
-                    if (getCaptureValue(move) == 0)
-                    {
-                        killerMoves[depth][1] = killerMoves[depth][0];
-                        killerMoves[depth][0] = move;
-                    }
-                    break;
-                }
+                    return other.score < bestScore - NEAR_BEST_MARGIN;
+                }), nearBest.end());
+            }
+            if (score >= bestScore - NEAR_BEST_MARGIN)
+            {
+                nearBest.push_back({move, score});
+            }
+            if (score >= beta)
+            {
+                break;
             }
-            // Zapis do tabeli transpozycji
-            transpositionTable[positionKey] = {minEval, depth, bestMove};
-            return minEval;
         }
+        return bestScore;
     }
 
-    Move iterativeDeepening(int maxDepth, float timeLimit)
+    PackedMove iterativeDeepening(int maxDepth, float timeLimit)
     {
-        Move bestMove = Move(-1, -1, -1, -1);
-        int bestValue = (currentPlayer == WHITE) ? INT_MIN : INT_MAX;
-        std::vector<Move> bestMoves;
-        auto startTime = std::chrono::steady_clock::now();
-        bool isMaximizing = (currentPlayer == WHITE);
+        maxDepth = std::min(maxDepth, +MAX_SEARCH_DEPTH);
+        PackedMove bestMove;
+        std::vector<PackedMove> bestMoves;
+        searchDeadline = std::chrono::steady_clock::now() +
+                         std::chrono::milliseconds(static_cast<int>(timeLimit * 1000));
+        searchNodes = 0;
+        searchStopped = false;
+        checkExtensions = 0;
+        ageMoveOrdering();
 
+        if (getAllPossibleMoves(currentPlayer).empty())
+        {
+            return PackedMove();
+        }
+
+        int previousScore = 0;
+        int olderScore = 0;
+        std::vector<ScoredMove> nearBest;
         for (int depth = 1; depth <= maxDepth; ++depth)
         {
-            int alpha = INT_MIN;
-            int beta = INT_MAX;
-            std::vector<Move> moves = getAllPossibleMoves(currentPlayer);
-            if (moves.empty())
+            // Okno aspiracji wokół wyników dwóch poprzednich iteracji, poszerzane dwukrotnie po każdym wyjściu
+            // poza nie. Ocena mocno zależy od tego, kto wykonał ostatni ruch, więc wynik skacze między iteracjami
+            // parzystymi i nieparzystymi - okno obejmuje ten skok. Przy płytkich iteracjach i ocenach matowych
+            // okno jest pełne.
+            int delta = ASPIRATION_WINDOW + std::abs(previousScore - olderScore) / 2;
+            int alpha = -INFINITE_SCORE;
+            int beta = INFINITE_SCORE;
+            if (depth >= ASPIRATION_MIN_DEPTH && std::abs(previousScore) < CHECKMATE_BONUS - MAX_PLY &&
+                std::abs(olderScore) < CHECKMATE_BONUS - MAX_PLY)
             {
-                return Move(-1, -1, -1, -1);
+                alpha = (previousScore + olderScore) / 2 - delta;
+                beta = (previousScore + olderScore) / 2 + delta;
             }
 
-            bestMoves.clear();
-            std::sort(moves.begin(), moves.end(), [this](const Move &a, const Move &b)
-            {
-                int scoreA = getCaptureValue(a) * CAPTURE_BONUS_MULTIPLIER;
-                int scoreB = getCaptureValue(b) * CAPTURE_BONUS_MULTIPLIER;
-                GameState stateA = makeTemporaryMove(a);
-                bool isCheckA = isInCheck(currentPlayer);
-                bool isMateA = isCheckA && getAllPossibleMoves(currentPlayer).empty();
-                undoMove(stateA);
-                scoreA += isMateA ? 999999 : (isCheckA ? 800 : 0);
-                GameState stateB = makeTemporaryMove(b);
-                bool isCheckB = isInCheck(currentPlayer);
-                bool isMateB = isCheckB && getAllPossibleMoves(currentPlayer).empty();
-                undoMove(stateB);
-                scoreB += isMateB ? 999999 : (isCheckB ? 800 : 0);
-                return scoreA > scoreB;
-            });
-
-            for (const Move &move: moves)
-            {
-                GameState state = makeTemporaryMove(move);
-                int moveValue;
-                if (board[move.toX][move.toY].type == PAWN && (move.toX == 0 || move.toX == 7))
+            PackedMove iterationBest = bestMove;
+            int score;
+            while (true)
+            {
+                score = searchRoot(depth, alpha, beta, iterationBest, nearBest);
+                if (searchStopped)
                 {
-                    int bestPromotionValue = isMaximizing ? INT_MIN : INT_MAX;
-                    PieceType bestPromotion = QUEEN;
-                    PieceType options[] = {QUEEN, ROOK, BISHOP, KNIGHT};
-                    for (PieceType option: options)
-                    {
-                        board[move.toX][move.toY] = Piece(option, board[move.toX][move.toY].color);
-                        int value = minimax(depth - 1, alpha, beta, !isMaximizing);
-                        if (isMaximizing && value > bestPromotionValue)
-                        {
-                            bestPromotionValue = value;
-                            bestPromotion = option;
-                        }
-                        else if (!isMaximizing && value < bestPromotionValue)
-                        {
-                            bestPromotionValue = value;
-                            bestPromotion = option;
-                        }
-                    }
-                    moveValue = bestPromotionValue;
-                    board[move.toX][move.toY] = Piece(bestPromotion, board[move.toX][move.toY].color);
-                    if (isMaximizing && moveValue > bestValue)
-                    {
-                        promotionChoice = bestPromotion;
-                    }
-                    else if (!isMaximizing && moveValue < bestValue)
-                    {
-                        promotionChoice = bestPromotion;
-                    }
+                    break;
                 }
-                else
+                if (score <= alpha)
                 {
-                    moveValue = minimax(depth - 1, alpha, beta, !isMaximizing);
+                    beta = (alpha + beta) / 2;
+                    alpha = std::max(score - delta, -INFINITE_SCORE);
                 }
-                undoMove(state);
-
-                if (isMaximizing)
+                else if (score >= beta)
                 {
-                    if (moveValue > bestValue)
-                    {
-                        bestValue = moveValue;
-                        bestMove = move;
-                        bestMoves.clear();
-                        bestMoves.push_back(move);
-                    }
-                    else if (moveValue >= bestValue - 20)
-                    {
-                        bestMoves.push_back(move);
-                    }
-                    alpha = std::max(alpha, moveValue);
+                    beta = std::min(score + delta, +INFINITE_SCORE); // Kopia stałej, jak w updateQuietStats
                 }
                 else
-                {
-                    if (moveValue < bestValue)
-                    {
-                        bestValue = moveValue;
-                        bestMove = move;
-                        bestMoves.clear();
-                        bestMoves.push_back(move);
-                    }
-                    else if (moveValue <= bestValue + 20)
-                    {
-                        bestMoves.push_back(move);
-                    }
-                    beta = std::min(beta, moveValue);
-                }
-
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::steady_clock::now() - startTime).count();
-                if (elapsed / 1000.0f > timeLimit)
                 {
                     break;
                 }
+                delta *= 2;
             }
 
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now() - startTime).count();
-            if (elapsed / 1000.0f > timeLimit)
+            // Przerwana iteracja nie ocenia wszystkich ruchów, więc zostaje wynik poprzedniej
+            if (searchStopped)
             {
                 break;
             }
+            olderScore = previousScore;
+            previousScore = score;
+            bestMove = iterationBest;
+            bestMoves.clear();
+            for (const ScoredMove &move: nearBest)
+            {
+                bestMoves.push_back(move);
+            }
         }
 
-        if (!bestMoves.empty() && bestMoves.size() > 1)
+        // Przy wyniku matowym ruchy różnią się odległością do mata, więc losowanie mogłoby odkładać mata
+        // bez końca - zostaje najkrótsza droga (albo najdłuższa obrona)
+        bool mateScore = std::abs(previousScore) >= CHECKMATE_BONUS - MAX_PLY;
+        if (!mateScore && bestMoves.size() > 1)
         {
-            std::vector<Move> captureMoves;
+            std::vector<PackedMove> captureMoves;
             for (const auto &move: bestMoves)
             {
                 if (getCaptureValue(move) > 0)
@@ -2351,39 +2218,42 @@ public:
         }
 
         // Sprawdzenie księgi debiutów
-        std::string positionKey = getPositionKey();
-        auto openingMove = openingBook.find(positionKey);
+        auto openingMove = openingBook.find(hashKey);
         if (openingMove != openingBook.end() && moveHistory.size() < 10)
         {
             logger.log("Using opening book move: " + openingMove->second.notation, Logger::INFO);
             return openingMove->second;
         }
 
-        Move bestMove = iterativeDeepening(depth + 2, 5.0f); // Limit czasu 3 sekundy
-        if (bestMove.fromX == -1)
+        transpositionTable.newSearch();
+        PackedMove bestMove = iterativeDeepening(depth + 2, 5.0f); // Limit czasu 3 sekundy
+        if (bestMove.isNull())
         {
-            std::vector<Move> moves = getAllPossibleMoves(currentPlayer);
-            if (!moves.empty())
+            MoveList moves = getAllPossibleMoves(currentPlayer);
+            if (moves.empty())
             {
-                bestMove = moves[0];
+                return Move(-1, -1, -1, -1);
             }
+            bestMove = moves[0];
         }
 
+        // Notację i współrzędne dostaje dopiero ruch przekazywany do GUI
+        Move move = bestMove.toMove();
         std::string moveStr =
-                "AI move: (" + std::to_string(bestMove.fromX) + "," + std::to_string(bestMove.fromY) + ") to (" +
-                std::to_string(bestMove.toX) + "," + std::to_string(bestMove.toY) + ") with value: " +
+                "AI move: (" + std::to_string(move.fromX) + "," + std::to_string(move.fromY) + ") to (" +
+                std::to_string(move.toX) + "," + std::to_string(move.toY) + ") with value: " +
                 std::to_string(evaluateBoard());
         logger.log(moveStr, Logger::INFO);
 
-        Piece piece = board[bestMove.fromX][bestMove.fromY];
-        if (piece.type == PAWN && (bestMove.toX == 0 || bestMove.toX == 7))
+        if (bestMove.flag() == PROMOTION_MOVE)
         {
+            promotionChoice = bestMove.promotion();
             isPawnPromotionPending = true;
-            promotionX = bestMove.toX;
-            promotionY = bestMove.toY;
+            promotionX = move.toX;
+            promotionY = move.toY;
         }
 
-        return bestMove;
+        return move;
     }
 
     Color getCurrentPlayer() const
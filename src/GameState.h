@@ -1,21 +1,22 @@
 #ifndef PROJEKT3_GAMESTATE_H
 #define PROJEKT3_GAMESTATE_H
 
+#include <cstdint>
 #include "Piece.h"
-#include "Move.h"
+#include "PackedMove.h"
 
-// Struktura do przechowywania stanu gry przed tymczasowym ruchem
-    struct GameState
-    {
-        Piece capturedPiece;
-        bool whiteCanCastleKingside;
-        bool whiteCanCastleQueenside;
-        bool blackCanCastleKingside;
-        bool blackCanCastleQueenside;
-        int enPassantTargetX;
-        int enPassantTargetY;
-        Move move;
-        Piece movedPiece;
-    };
+// Rekord cofania ruchu: wszystko, czego nie da się odtworzyć z samego ruchu.
+// Figura promocji zapisana jest w ruchu, a przy biciu w przelocie capturedPiece to zbity pionek.
+struct GameState
+{
+    PackedMove move;
+    Piece movedPiece;
+    Piece capturedPiece;
+    uint8_t castlingRights;
+    int8_t enPassantTargetX;
+    int8_t enPassantTargetY;
+    int halfmoveClock;
+    uint64_t hashKey; // Klucz Zobrista sprzed ruchu
+};
 
 #endif //PROJEKT3_GAMESTATE_H
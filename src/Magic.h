@@ -0,0 +1,141 @@
+#ifndef PROJEKT3_MAGIC_H
+#define PROJEKT3_MAGIC_H
+
+#include <vector>
+#include "Bitboard.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Ataki gońca i wieży z tablic indeksowanych zajętością pól na promieniach.
+// Przy kompilacji z BMI2 indeks liczy instrukcja PEXT, w przeciwnym razie mnożenie przez liczbę magiczną.
+struct Magic
+{
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard *attacks;
+    int shift;
+
+    unsigned index(Bitboard occupied) const
+    {
+#if defined(__BMI2__)
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+class SliderAttacks
+{
+private:
+    Bitboard rookTable[0x19000];
+    Bitboard bishopTable[0x1480];
+
+    // Generator xorshift64* ze stałym ziarnem - te same liczby magiczne przy każdym uruchomieniu
+    static Bitboard nextRandom(Bitboard &state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    static void initMagics(Bitboard table[], Magic magics[], const int directions[][2])
+    {
+        std::vector<Bitboard> occupancy(4096), reference(4096);
+        std::vector<int> epoch(4096, 0);
+        // Ziarna dobrane tak, żeby poszukiwanie kończyło się szybko (po jednym na wiersz)
+        const Bitboard seeds[8] = {728, 2985, 786, 2501, 2009, 2821, 1699, 255};
+        int attempt = 0;
+        int size = 0;
+
+        for (int square = 0; square < 64; ++square)
+        {
+            // Pola brzegowe nie wpływają na atak, więc nie wchodzą do maski
+            Bitboard edges = ((ROW_0_BB | ROW_7_BB) & ~rowBB(squareRow(square))) |
+                             ((COLUMN_A_BB | COLUMN_H_BB) & ~columnBB(squareColumn(square)));
+
+            Magic &m = magics[square];
+            m.mask = slidingAttacks(square, 0, directions, 4) & ~edges;
+            m.shift = 64 - popCount(m.mask);
+            m.attacks = square == 0 ? table : magics[square - 1].attacks + size;
+
+            // Wszystkie podzbiory maski (carry-rippler) i odpowiadające im ataki
+            Bitboard b = 0;
+            size = 0;
+            do
+            {
+                occupancy[size] = b;
+                reference[size] = slidingAttacks(square, b, directions, 4);
+#if defined(__BMI2__)
+                m.attacks[m.index(b)] = reference[size];
+#endif
+                size++;
+                b = (b - m.mask) & m.mask;
+            } while (b);
+
+#if !defined(__BMI2__)
+            Bitboard randomState = seeds[squareRow(square)];
+            // Losujemy rzadkie liczby aż do znalezienia takiej bez szkodliwych kolizji
+            for (int i = 0; i < size;)
+            {
+                for (m.magic = 0; popCount((m.magic * m.mask) >> 56) < 6;)
+                {
+                    m.magic = nextRandom(randomState) & nextRandom(randomState) & nextRandom(randomState);
+                }
+
+                for (++attempt, i = 0; i < size; ++i)
+                {
+                    unsigned idx = m.index(occupancy[i]);
+                    if (epoch[idx] < attempt)
+                    {
+                        epoch[idx] = attempt;
+                        m.attacks[idx] = reference[i];
+                    }
+                    else if (m.attacks[idx] != reference[i])
+                    {
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+public:
+    Magic rookMagics[64];
+    Magic bishopMagics[64];
+
+    SliderAttacks()
+    {
+        initMagics(rookTable, rookMagics, ROOK_DIRECTIONS);
+        initMagics(bishopTable, bishopMagics, BISHOP_DIRECTIONS);
+    }
+};
+
+inline const SliderAttacks &sliderAttacks()
+{
+    static const SliderAttacks tables;
+    return tables;
+}
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied)
+{
+    const Magic &m = sliderAttacks().bishopMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard rookAttacks(int square, Bitboard occupied)
+{
+    const Magic &m = sliderAttacks().rookMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int square, Bitboard occupied)
+{
+    return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
+
+#endif //PROJEKT3_MAGIC_H
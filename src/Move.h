@@ -1,6 +1,7 @@
 #ifndef PROJEKT3_MOVE_H
 #define PROJEKT3_MOVE_H
 
+#include <string>
 #include "PieceType.h"
 #include "Piece.h"
 
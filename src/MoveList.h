@@ -0,0 +1,92 @@
+#ifndef PROJEKT3_MOVELIST_H
+#define PROJEKT3_MOVELIST_H
+
+#include "PackedMove.h"
+
+// Ruch razem z oceną używaną przy sortowaniu
+struct ScoredMove
+{
+    PackedMove move;
+    int score;
+
+    operator PackedMove() const
+    {
+        return move;
+    }
+
+    bool operator==(const PackedMove &other) const
+    {
+        return move == other;
+    }
+};
+
+// Lista ruchów o stałej pojemności, bez alokacji na stercie.
+// Żadna legalna pozycja nie ma więcej niż 218 ruchów, więc 256 miejsc zawsze wystarcza.
+class MoveList
+{
+public:
+    static const int MAX_MOVES = 256;
+
+private:
+    ScoredMove moves[MAX_MOVES];
+    int count;
+
+public:
+    MoveList() : count(0)
+    {
+    }
+
+    void push_back(const PackedMove &move)
+    {
+        moves[count].move = move;
+        moves[count].score = 0;
+        count++;
+    }
+
+    void clear()
+    {
+        count = 0;
+    }
+
+    int size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    ScoredMove &operator[](int index)
+    {
+        return moves[index];
+    }
+
+    const ScoredMove &operator[](int index) const
+    {
+        return moves[index];
+    }
+
+    ScoredMove *begin()
+    {
+        return moves;
+    }
+
+    ScoredMove *end()
+    {
+        return moves + count;
+    }
+
+    const ScoredMove *begin() const
+    {
+        return moves;
+    }
+
+    const ScoredMove *end() const
+    {
+        return moves + count;
+    }
+};
+
+#endif //PROJEKT3_MOVELIST_H
@@ -0,0 +1,73 @@
+#ifndef PROJEKT3_MOVEPICKER_H
+#define PROJEKT3_MOVEPICKER_H
+
+#include <utility>
+#include "MoveList.h"
+
+// Kolejność etapów: ruch z tabeli transpozycji, bicia nietracące materiału, ruchy killer i odpowiedź na ruch
+// przeciwnika, pozostałe ruchy ciche i na końcu bicia tracące materiał
+enum PickStage
+{
+    PICK_TT_MOVE, PICK_INIT_CAPTURES, PICK_GOOD_CAPTURES, PICK_REFUTATIONS, PICK_INIT_QUIETS, PICK_QUIETS,
+    PICK_BAD_CAPTURES, PICK_DONE
+};
+
+// Stan wybierania kolejnych ruchów z listy ruchów legalnych. Lista dzielona jest na obszary
+// [bicia dobre | ruchy ciche | bicia złe], a z obszaru bieżącego etapu brany jest najlepszy z pozostałych ruchów
+// (sortowanie przez wybór). Po odcięciu reszta listy nie jest więc ani sortowana, ani oceniana.
+// Ocenę ruchów i przejścia między etapami prowadzi ChessGame::nextMove.
+struct MovePicker
+{
+    static const int REFUTATION_COUNT = 3;
+
+    MoveList &moves;
+    PackedMove ttMove;
+    PackedMove refutations[REFUTATION_COUNT]; // Dwa killery i odpowiedź na poprzedni ruch
+    PickStage stage;
+    int current; // Pierwszy ruch jeszcze nie zwrócony
+    int goodCapturesEnd;
+    int quietsEnd;
+    int refutationIndex;
+
+    MovePicker(MoveList &moves, PackedMove ttMove, PackedMove killer1, PackedMove killer2, PackedMove counterMove)
+            : moves(moves), ttMove(ttMove), refutations{killer1, killer2, counterMove}, stage(PICK_TT_MOVE),
+              current(0), goodCapturesEnd(0), quietsEnd(0), refutationIndex(0)
+    {
+    }
+
+    // Najlepszy ruch z [current, end) trafia na pozycję current i jest zwracany
+    PackedMove pickBest(int end)
+    {
+        int best = current;
+        for (int i = current + 1; i < end; ++i)
+        {
+            if (moves[i].score > moves[best].score)
+            {
+                best = i;
+            }
+        }
+        std::swap(moves[current], moves[best]);
+        return moves[current++].move;
+    }
+
+    // Przeniesienie podanego ruchu na pozycję current, o ile jest wśród ruchów [current, end)
+    bool takeMove(PackedMove move, int end)
+    {
+        if (move.isNull())
+        {
+            return false;
+        }
+        for (int i = current; i < end; ++i)
+        {
+            if (moves[i] == move)
+            {
+                std::swap(moves[current], moves[i]);
+                current++;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif //PROJEKT3_MOVEPICKER_H
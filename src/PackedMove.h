@@ -0,0 +1,89 @@
+#ifndef PROJEKT3_PACKEDMOVE_H
+#define PROJEKT3_PACKEDMOVE_H
+
+#include <cstdint>
+#include <string>
+#include "PieceType.h"
+#include "Move.h"
+#include "Bitboard.h"
+
+// Rodzaj ruchu zapisany w dwóch najstarszych bitach
+enum MoveFlag
+{
+    NORMAL_MOVE = 0, PROMOTION_MOVE = 1 << 14, EN_PASSANT_MOVE = 2 << 14, CASTLING_MOVE = 3 << 14
+};
+
+// Ruch silnika w 16 bitach: bity 0-5 pole startowe, 6-11 pole docelowe,
+// 12-13 figura promocji (KNIGHT..QUEEN), 14-15 rodzaj ruchu.
+// Notacja powstaje dopiero przy zapisie do historii (Move).
+struct PackedMove
+{
+    uint16_t data;
+
+    PackedMove() : data(0)
+    {
+    }
+
+    PackedMove(int from, int to, MoveFlag flag = NORMAL_MOVE, PieceType promotion = KNIGHT)
+            : data(static_cast<uint16_t>(from | (to << 6) | ((promotion - KNIGHT) << 12) | flag))
+    {
+    }
+
+    int from() const
+    {
+        return data & 0x3F;
+    }
+
+    int to() const
+    {
+        return (data >> 6) & 0x3F;
+    }
+
+    MoveFlag flag() const
+    {
+        return static_cast<MoveFlag>(data & (3 << 14));
+    }
+
+    PieceType promotion() const
+    {
+        return static_cast<PieceType>(((data >> 12) & 3) + KNIGHT);
+    }
+
+    // Ruch a8-a8 nigdy nie jest legalny, więc zerowe dane oznaczają brak ruchu
+    bool isNull() const
+    {
+        return data == 0;
+    }
+
+    Move toMove() const
+    {
+        return Move(squareRow(from()), squareColumn(from()), squareRow(to()), squareColumn(to()));
+    }
+
+    // Zapis współrzędnych pól, np. e2e4 albo e7e8q
+    std::string toString() const
+    {
+        std::string text;
+        text += static_cast<char>('a' + squareColumn(from()));
+        text += static_cast<char>('8' - squareRow(from()));
+        text += static_cast<char>('a' + squareColumn(to()));
+        text += static_cast<char>('8' - squareRow(to()));
+        if (flag() == PROMOTION_MOVE)
+        {
+            text += "nbrq"[promotion() - KNIGHT];
+        }
+        return text;
+    }
+
+    bool operator==(const PackedMove &other) const
+    {
+        return data == other.data;
+    }
+
+    bool operator!=(const PackedMove &other) const
+    {
+        return data != other.data;
+    }
+};
+
+#endif //PROJEKT3_PACKEDMOVE_H
@@ -0,0 +1,56 @@
+#ifndef PROJEKT3_PAWNHASHTABLE_H
+#define PROJEKT3_PAWNHASHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// Ocena układu pionków, zależna tylko od pionków obu stron. Osłona króla zależy dodatkowo od pola króla,
+// więc jest zapamiętywana razem z tym polem i liczona ponownie dopiero, gdy król się przesunie.
+struct PawnEntry
+{
+    uint64_t key = 0; // Klucz Zobrista samych pionków
+    int structure = 0; // Podwójne, izolowane i wolne pionki, z punktu widzenia białych
+    int promotion = 0; // Premia za pionki blisko promocji, z punktu widzenia białych
+    int kingSquare[2] = {-1, -1}; // Pole króla, dla którego policzono shield
+    int shield[2] = {0, 0}; // Osłona króla pionkami (bez znaku)
+};
+
+// Tabela pionków o stałym rozmiarze 2^n wpisów, zastępowanie zawsze. Układ pionków między sąsiednimi węzłami
+// zmienia się rzadko, więc prawie każda ocena trafia w gotowy wpis.
+class PawnHashTable
+{
+    std::vector<PawnEntry> entries;
+    size_t mask;
+
+public:
+    // Rozmiar zaokrąglany w dół do potęgi dwójki wpisów
+    explicit PawnHashTable(size_t kilobytes)
+    {
+        size_t count = 1;
+        while (count * 2 * sizeof(PawnEntry) <= std::max<size_t>(kilobytes, 1) << 10)
+        {
+            count *= 2;
+        }
+        entries.resize(count);
+        mask = count - 1;
+    }
+
+    PawnHashTable(const PawnHashTable &) = delete;
+
+    PawnHashTable &operator=(const PawnHashTable &) = delete;
+
+    // Wpis dla klucza; przy innym kluczu wywołujący nadpisuje go nową oceną
+    PawnEntry &entry(uint64_t key)
+    {
+        return entries[key & mask];
+    }
+
+    void clear()
+    {
+        std::fill(entries.begin(), entries.end(), PawnEntry());
+    }
+};
+
+#endif //PROJEKT3_PAWNHASHTABLE_H
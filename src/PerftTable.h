@@ -0,0 +1,65 @@
+#ifndef PROJEKT3_PERFTTABLE_H
+#define PROJEKT3_PERFTTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+
+// Tabela wyników perft współdzielona przez wątki bez blokad. Wpis to dwa słowa: dane (liczba węzłów
+// i głębokość) oraz klucz XOR dane. Wpis rozerwany przez równoczesny zapis innego wątku nie przejdzie
+// sprawdzenia klucza, więc jest traktowany jak brak trafienia.
+class PerftTable
+{
+    struct Entry
+    {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+
+public:
+    // Rozmiar zaokrąglany w dół do potęgi dwójki wpisów
+    explicit PerftTable(size_t megabytes)
+    {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= std::max<size_t>(megabytes, 1) << 20)
+        {
+            count *= 2;
+        }
+        entries.reset(new Entry[count]);
+        mask = count - 1;
+        for (size_t i = 0; i < count; ++i)
+        {
+            entries[i].check.store(0, std::memory_order_relaxed);
+            entries[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool probe(uint64_t key, int depth, uint64_t &nodes) const
+    {
+        const Entry &entry = entries[key & mask];
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth)
+        {
+            return false;
+        }
+        nodes = data >> 8;
+        return true;
+    }
+
+    // Liczba węzłów zajmuje 56 bitów, co wystarcza dla każdej realnej głębokości
+    void store(uint64_t key, int depth, uint64_t nodes)
+    {
+        Entry &entry = entries[key & mask];
+        uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+};
+
+#endif //PROJEKT3_PERFTTABLE_H
@@ -0,0 +1,172 @@
+#ifndef PROJEKT3_PIECESQUARETABLES_H
+#define PROJEKT3_PIECESQUARETABLES_H
+
+#include "PieceType.h"
+#include "Color.h"
+
+// Wartości figur w środkowej i końcowej fazie gry (król nie ma wartości materialnej)
+const int MG_PIECE_VALUE[6] = {100, 320, 330, 500, 900, 0};
+const int EG_PIECE_VALUE[6] = {110, 300, 320, 520, 900, 0};
+
+// Udział figur w fazie gry: pełny komplet figur bez pionków daje MAX_PHASE (środkowa gra), brak figur daje 0
+const int PHASE_WEIGHT[6] = {0, 1, 1, 2, 4, 0};
+const int MAX_PHASE = 24;
+
+// Premie pozycyjne z punktu widzenia białych, wiersz po wierszu od 8. linii (tak jak indeksy pól).
+// Dla czarnych tablica jest odbijana względem środka planszy.
+const int MG_POSITION_BONUS[6][64] = {
+        { // PAWN
+                0, 0, 0, 0, 0, 0, 0, 0,
+                50, 50, 50, 50, 50, 50, 50, 50,
+                10, 10, 20, 30, 30, 20, 10, 10,
+                5, 5, 10, 25, 25, 10, 5, 5,
+                0, 0, 0, 20, 20, 0, 0, 0,
+                5, -5, -10, 0, 0, -10, -5, 5,
+                5, 10, 10, -20, -20, 10, 10, 5,
+                0, 0, 0, 0, 0, 0, 0, 0
+        },
+        { // KNIGHT
+                -50, -40, -30, -30, -30, -30, -40, -50,
+                -40, -20, 0, 0, 0, 0, -20, -40,
+                -30, 0, 10, 15, 15, 10, 0, -30,
+                -30, 5, 15, 20, 20, 15, 5, -30,
+                -30, 0, 15, 20, 20, 15, 0, -30,
+                -30, 5, 10, 15, 15, 10, 5, -30,
+                -40, -20, 0, 5, 5, 0, -20, -40,
+                -50, -40, -30, -30, -30, -30, -40, -50
+        },
+        { // BISHOP
+                -20, -10, -10, -10, -10, -10, -10, -20,
+                -10, 0, 0, 0, 0, 0, 0, -10,
+                -10, 0, 5, 10, 10, 5, 0, -10,
+                -10, 5, 5, 10, 10, 5, 5, -10,
+                -10, 0, 10, 10, 10, 10, 0, -10,
+                -10, 10, 10, 10, 10, 10, 10, -10,
+                -10, 5, 0, 0, 0, 0, 5, -10,
+                -20, -10, -10, -10, -10, -10, -10, -20
+        },
+        { // ROOK
+                0, 0, 0, 0, 0, 0, 0, 0,
+                5, 10, 10, 10, 10, 10, 10, 5,
+                -5, 0, 0, 0, 0, 0, 0, -5,
+                -5, 0, 0, 0, 0, 0, 0, -5,
+                -5, 0, 0, 0, 0, 0, 0, -5,
+                -5, 0, 0, 0, 0, 0, 0, -5,
+                -5, 0, 0, 0, 0, 0, 0, -5,
+                0, 0, 0, 5, 5, 0, 0, 0
+        },
+        { // QUEEN
+                -20, -10, -10, -5, -5, -10, -10, -20,
+                -10, 0, 0, 0, 0, 0, 0, -10,
+                -10, 0, 5, 5, 5, 5, 0, -10,
+                -5, 0, 5, 5, 5, 5, 0, -5,
+                0, 0, 5, 5, 5, 5, 0, -5,
+                -10, 5, 5, 5, 5, 5, 0, -10,
+                -10, 0, 5, 0, 0, 0, 0, -10,
+                -20, -10, -10, -5, -5, -10, -10, -20
+        },
+        { // KING - schowany za pionkami
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -30, -40, -40, -50, -50, -40, -40, -30,
+                -20, -30, -30, -40, -40, -30, -30, -20,
+                -10, -20, -20, -20, -20, -20, -20, -10,
+                20, 20, 0, 0, 0, 0, 20, 20,
+                20, 30, 10, 0, 0, 10, 30, 20
+        }
+};
+
+// W końcówce liczy się przede wszystkim postęp pionków i aktywny król
+const int EG_POSITION_BONUS[6][64] = {
+        { // PAWN
+                0, 0, 0, 0, 0, 0, 0, 0,
+                80, 80, 80, 80, 80, 80, 80, 80,
+                50, 50, 50, 50, 50, 50, 50, 50,
+                30, 30, 30, 30, 30, 30, 30, 30,
+                20, 20, 20, 20, 20, 20, 20, 20,
+                10, 10, 10, 10, 10, 10, 10, 10,
+                10, 10, 10, 10, 10, 10, 10, 10,
+                0, 0, 0, 0, 0, 0, 0, 0
+        },
+        { // KNIGHT
+                -50, -40, -30, -30, -30, -30, -40, -50,
+                -40, -20, 0, 0, 0, 0, -20, -40,
+                -30, 0, 10, 15, 15, 10, 0, -30,
+                -30, 5, 15, 20, 20, 15, 5, -30,
+                -30, 0, 15, 20, 20, 15, 0, -30,
+                -30, 5, 10, 15, 15, 10, 5, -30,
+                -40, -20, 0, 5, 5, 0, -20, -40,
+                -50, -40, -30, -30, -30, -30, -40, -50
+        },
+        { // BISHOP
+                -20, -10, -10, -10, -10, -10, -10, -20,
+                -10, 0, 0, 0, 0, 0, 0, -10,
+                -10, 0, 5, 10, 10, 5, 0, -10,
+                -10, 5, 5, 10, 10, 5, 5, -10,
+                -10, 0, 10, 10, 10, 10, 0, -10,
+                -10, 10, 10, 10, 10, 10, 10, -10,
+                -10, 5, 0, 0, 0, 0, 5, -10,
+                -20, -10, -10, -10, -10, -10, -10, -20
+        },
+        { // ROOK
+                0, 0, 0, 0, 0, 0, 0, 0,
+                5, 10, 10, 10, 10, 10, 10, 5,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0, 0, 0
+        },
+        { // QUEEN
+                -20, -10, -10, -5, -5, -10, -10, -20,
+                -10, 0, 0, 0, 0, 0, 0, -10,
+                -10, 0, 5, 5, 5, 5, 0, -10,
+                -5, 0, 5, 5, 5, 5, 0, -5,
+                -5, 0, 5, 5, 5, 5, 0, -5,
+                -10, 0, 5, 5, 5, 5, 0, -10,
+                -10, 0, 0, 0, 0, 0, 0, -10,
+                -20, -10, -10, -5, -5, -10, -10, -20
+        },
+        { // KING - w centrum planszy
+                -50, -40, -30, -20, -20, -30, -40, -50,
+                -30, -20, -10, 0, 0, -10, -20, -30,
+                -30, -10, 20, 30, 30, 20, -10, -30,
+                -30, -10, 30, 40, 40, 30, -10, -30,
+                -30, -10, 30, 40, 40, 30, -10, -30,
+                -30, -10, 20, 30, 30, 20, -10, -30,
+                -30, -30, 0, 0, 0, 0, -30, -30,
+                -50, -30, -30, -30, -30, -30, -30, -50
+        }
+};
+
+// Wartość figury razem z premią pozycyjną, dla obu faz, kolorów i wszystkich pól
+struct PieceSquareTable
+{
+    int mg[2][6][64];
+    int eg[2][6][64];
+
+    PieceSquareTable()
+    {
+        for (int type = PAWN; type <= KING; ++type)
+        {
+            for (int square = 0; square < 64; ++square)
+            {
+                // Odbicie pionowe: pole x * 8 + y przechodzi w (7 - x) * 8 + y
+                mg[WHITE][type][square] = MG_PIECE_VALUE[type] + MG_POSITION_BONUS[type][square];
+                eg[WHITE][type][square] = EG_PIECE_VALUE[type] + EG_POSITION_BONUS[type][square];
+                mg[BLACK][type][square] = MG_PIECE_VALUE[type] + MG_POSITION_BONUS[type][square ^ 56];
+                eg[BLACK][type][square] = EG_PIECE_VALUE[type] + EG_POSITION_BONUS[type][square ^ 56];
+            }
+        }
+    }
+};
+
+inline const PieceSquareTable &pieceSquareTable()
+{
+    static const PieceSquareTable table;
+    return table;
+}
+
+#endif //PROJEKT3_PIECESQUARETABLES_H
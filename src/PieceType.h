@@ -6,4 +6,32 @@ enum PieceType
     PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING
 };
 
+// Typ figury z litery zapisu FEN (wielkość litery oznacza kolor, tutaj nie ma znaczenia)
+inline bool pieceTypeFromChar(char c, PieceType &type)
+{
+    switch (c | 0x20)
+    {
+        case 'p':
+            type = PAWN;
+            return true;
+        case 'n':
+            type = KNIGHT;
+            return true;
+        case 'b':
+            type = BISHOP;
+            return true;
+        case 'r':
+            type = ROOK;
+            return true;
+        case 'q':
+            type = QUEEN;
+            return true;
+        case 'k':
+            type = KING;
+            return true;
+        default:
+            return false;
+    }
+}
+
 #endif //PROJEKT3_PIECETYPE_H
@@ -0,0 +1,21 @@
+#ifndef PROJEKT3_PRUNINGMARGINS_H
+#define PROJEKT3_PRUNINGMARGINS_H
+
+// Marginesy przycinania węzłów blisko liści, liczone na jeden ply pozostałej głębokości.
+// Domyślne wartości można zmienić przez ChessGame::setPruningMargins.
+struct PruningMargins
+{
+    // Reverse futility: ocena statyczna o tyle powyżej beta kończy węzeł bez przeszukiwania
+    int reverseFutility = 150;
+    int reverseFutilityDepth = 3;
+
+    // Futility: ruchy ciche pomijane, gdy ocena statyczna z tym zapasem nie sięga alpha
+    int futility = 175;
+    int futilityDepth = 2;
+
+    // Razoring: przy ocenie o tyle poniżej alpha węzeł sprawdza tylko quiescenceSearch
+    int razoring = 350;
+    int razoringDepth = 2;
+};
+
+#endif //PROJEKT3_PRUNINGMARGINS_H
@@ -0,0 +1,42 @@
+#ifndef PROJEKT3_REDUCTIONS_H
+#define PROJEKT3_REDUCTIONS_H
+
+#include <cmath>
+#include <algorithm>
+
+// Podstawowa redukcja late move reductions: rośnie z logarytmem głębokości i logarytmem numeru ruchu,
+// więc późne ruchy na dużej głębokości są przeszukiwane najpłycej
+struct LateMoveReductions
+{
+    static const int MAX_DEPTH = 64;
+    static const int MAX_MOVES = 256;
+
+    int table[MAX_DEPTH][MAX_MOVES];
+
+    LateMoveReductions()
+    {
+        for (int depth = 0; depth < MAX_DEPTH; ++depth)
+        {
+            for (int move = 0; move < MAX_MOVES; ++move)
+            {
+                table[depth][move] = depth == 0 || move == 0
+                                     ? 0 : static_cast<int>(0.75 + std::log(depth) * std::log(move) / 2.25);
+            }
+        }
+    }
+};
+
+inline const LateMoveReductions &lateMoveReductions()
+{
+    static const LateMoveReductions reductions;
+    return reductions;
+}
+
+// Redukcja dla ruchu o numerze moveIndex (od 1) przy pozostałej głębokości depth
+inline int lateMoveReduction(int depth, int moveIndex)
+{
+    return lateMoveReductions().table[std::min(depth, LateMoveReductions::MAX_DEPTH - 1)]
+    [std::min(moveIndex, LateMoveReductions::MAX_MOVES - 1)];
+}
+
+#endif //PROJEKT3_REDUCTIONS_H
@@ -1,14 +1,33 @@
 #ifndef PROJEKT3_TRANSPOSITIONENTRY_H
 #define PROJEKT3_TRANSPOSITIONENTRY_H
 
-#include "Move.h"
+#include <cstdint>
+#include "PackedMove.h"
 
-// Struktura dla tabeli transpozycji
+// Rodzaj zapisanej wartości: dokładna albo tylko ograniczenie z góry / z dołu
+enum Bound : uint8_t
+{
+    BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT
+};
+
+// Struktura dla tabeli transpozycji - 12 bajtów, pięć wpisów mieści się w 64-bajtowym kubełku
 struct TranspositionEntry
 {
-    int value;
-    int depth;
-    Move bestMove;
+    uint32_t key; // Górne 32 bity klucza Zobrista (dolne wybierają kubełek)
+    int32_t value;
+    PackedMove bestMove;
+    int8_t depth;
+    uint8_t genBound; // Generacja wyszukiwania (6 bitów) i rodzaj wartości (2 bity)
+
+    Bound bound() const
+    {
+        return static_cast<Bound>(genBound & 3);
+    }
+
+    int generation() const
+    {
+        return genBound >> 2;
+    }
 };
 
 #endif //PROJEKT3_TRANSPOSITIONENTRY_H
@@ -0,0 +1,124 @@
+#ifndef PROJEKT3_TRANSPOSITIONTABLE_H
+#define PROJEKT3_TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "TranspositionEntry.h"
+
+// Tabela transpozycji o stałym rozmiarze: 2^n kubełków po 64 bajty (jedna linia pamięci podręcznej),
+// więc sprawdzenie pozycji to jeden dostęp do pamięci. Przy braku miejsca w kubełku wypierany jest
+// wpis najpłytszy i najstarszy.
+class TranspositionTable
+{
+public:
+    static const int BUCKET_SIZE = 5;
+
+private:
+    struct Bucket
+    {
+        TranspositionEntry entries[BUCKET_SIZE];
+        char padding[64 - BUCKET_SIZE * sizeof(TranspositionEntry)];
+    };
+
+    static_assert(sizeof(TranspositionEntry) == 12, "TranspositionEntry powinien mieć 12 bajtów");
+    static_assert(sizeof(Bucket) == 64, "Kubełek powinien mieć rozmiar linii pamięci podręcznej");
+
+    std::vector<char> memory;
+    Bucket *buckets;
+    size_t bucketMask;
+    uint8_t generation;
+
+    // Im mniejsza wartość, tym chętniej wpis zostanie wyparty
+    int replacementScore(const TranspositionEntry &entry) const
+    {
+        return entry.depth - 8 * ((generation - entry.generation()) & 63);
+    }
+
+public:
+    explicit TranspositionTable(size_t megabytes) : buckets(nullptr), bucketMask(0), generation(0)
+    {
+        resize(megabytes);
+    }
+
+    TranspositionTable(const TranspositionTable &) = delete;
+
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    // Rozmiar zaokrąglany w dół do potęgi dwójki kubełków
+    void resize(size_t megabytes)
+    {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= std::max<size_t>(megabytes, 1) << 20)
+        {
+            count *= 2;
+        }
+        memory.assign(count * sizeof(Bucket) + 63, 0);
+        uintptr_t address = (reinterpret_cast<uintptr_t>(memory.data()) + 63) & ~static_cast<uintptr_t>(63);
+        buckets = reinterpret_cast<Bucket *>(address);
+        bucketMask = count - 1;
+        clear();
+    }
+
+    void clear()
+    {
+        if (buckets)
+        {
+            std::fill(buckets, buckets + bucketMask + 1, Bucket());
+        }
+        generation = 0;
+    }
+
+    // Wywoływane przed każdym wyszukiwaniem, żeby wpisy z poprzednich ruchów traciły pierwszeństwo
+    void newSearch()
+    {
+        generation = (generation + 1) & 63;
+    }
+
+    bool probe(uint64_t key, TranspositionEntry &result) const
+    {
+        const Bucket &bucket = buckets[key & bucketMask];
+        uint32_t check = static_cast<uint32_t>(key >> 32);
+        for (const TranspositionEntry &entry: bucket.entries)
+        {
+            if (entry.key == check && entry.bound() != BOUND_NONE)
+            {
+                result = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, int value, int depth, Bound bound, PackedMove bestMove)
+    {
+        Bucket &bucket = buckets[key & bucketMask];
+        uint32_t check = static_cast<uint32_t>(key >> 32);
+        TranspositionEntry *replace = &bucket.entries[0];
+        for (TranspositionEntry &entry: bucket.entries)
+        {
+            if (entry.key == check || entry.bound() == BOUND_NONE)
+            {
+                replace = &entry;
+                break;
+            }
+            if (replacementScore(entry) < replacementScore(*replace))
+            {
+                replace = &entry;
+            }
+        }
+
+        // Przy tej samej pozycji bez nowego ruchu zostawiamy poprzedni najlepszy ruch
+        if (!bestMove.isNull() || replace->key != check)
+        {
+            replace->bestMove = bestMove;
+        }
+        replace->key = check;
+        replace->value = value;
+        replace->depth = static_cast<int8_t>(std::min(depth, 127));
+        replace->genBound = static_cast<uint8_t>((generation << 2) | bound);
+    }
+};
+
+#endif //PROJEKT3_TRANSPOSITIONTABLE_H
@@ -0,0 +1,139 @@
+#ifndef PROJEKT3_ZOBRIST_H
+#define PROJEKT3_ZOBRIST_H
+
+#include <cstdint>
+#include <string>
+#include "Piece.h"
+
+// Bity praw do roszady w kluczu pozycji
+enum CastlingRight
+{
+    WHITE_KINGSIDE = 1, WHITE_QUEENSIDE = 2, BLACK_KINGSIDE = 4, BLACK_QUEENSIDE = 8,
+    WHITE_CASTLING = WHITE_KINGSIDE | WHITE_QUEENSIDE, BLACK_CASTLING = BLACK_KINGSIDE | BLACK_QUEENSIDE,
+    ALL_CASTLING = WHITE_CASTLING | BLACK_CASTLING
+};
+
+// Losowe klucze Zobrista: figura na polu, prawa do roszady, kolumna bicia w przelocie i strona na posunięciu.
+// Klucz pozycji to XOR kluczy wszystkich jej składników, więc ruch zmienia go kilkoma operacjami XOR.
+struct ZobristKeys
+{
+    uint64_t piece[2][6][64];
+    uint64_t castling[16];
+    uint64_t enPassant[8];
+    uint64_t side;
+
+    ZobristKeys()
+    {
+        // xorshift64* ze stałym ziarnem, żeby klucze były takie same przy każdym uruchomieniu
+        uint64_t state = 1070372ULL;
+        auto next = [&state]()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        };
+
+        for (auto &color: piece)
+        {
+            for (auto &type: color)
+            {
+                for (uint64_t &key: type)
+                {
+                    key = next();
+                }
+            }
+        }
+        // Klucz kombinacji praw to XOR kluczy pojedynczych praw
+        uint64_t rightKeys[4] = {next(), next(), next(), next()};
+        for (int rights = 0; rights < 16; ++rights)
+        {
+            castling[rights] = 0;
+            for (int bit = 0; bit < 4; ++bit)
+            {
+                if (rights & (1 << bit))
+                {
+                    castling[rights] ^= rightKeys[bit];
+                }
+            }
+        }
+        for (uint64_t &key: enPassant)
+        {
+            key = next();
+        }
+        side = next();
+    }
+};
+
+inline const ZobristKeys &zobrist()
+{
+    static const ZobristKeys keys;
+    return keys;
+}
+
+// Klucz pozycji zapisanej w FEN (liczniki posunięć nie wchodzą do klucza). Używany przy budowie księgi debiutów.
+inline uint64_t zobristKeyFromFen(const std::string &fen)
+{
+    const ZobristKeys &keys = zobrist();
+    uint64_t key = 0;
+    size_t i = 0;
+    int square = 0;
+    for (; i < fen.size() && fen[i] != ' '; ++i)
+    {
+        char c = fen[i];
+        if (c == '/')
+        {
+            continue;
+        }
+        if (c >= '1' && c <= '8')
+        {
+            square += c - '0';
+            continue;
+        }
+
+        Color color = (c >= 'A' && c <= 'Z') ? WHITE : BLACK;
+        PieceType type;
+        if (!pieceTypeFromChar(c, type) || square >= 64)
+        {
+            continue;
+        }
+        key ^= keys.piece[color][type][square++];
+    }
+
+    if (i + 1 < fen.size() && fen[i + 1] == 'b')
+    {
+        key ^= keys.side;
+    }
+    i += 3;
+
+    int rights = 0;
+    for (; i < fen.size() && fen[i] != ' '; ++i)
+    {
+        switch (fen[i])
+        {
+            case 'K':
+                rights |= WHITE_KINGSIDE;
+                break;
+            case 'Q':
+                rights |= WHITE_QUEENSIDE;
+                break;
+            case 'k':
+                rights |= BLACK_KINGSIDE;
+                break;
+            case 'q':
+                rights |= BLACK_QUEENSIDE;
+                break;
+            default:
+                break;
+        }
+    }
+    key ^= keys.castling[rights];
+
+    if (i + 1 < fen.size() && fen[i + 1] != '-')
+    {
+        key ^= keys.enPassant[fen[i + 1] - 'a'];
+    }
+    return key;
+}
+
+#endif //PROJEKT3_ZOBRIST_H
@@ -0,0 +1,241 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ChessGame.h"
+
+// Pozycje wzorcowe z ogólnie znanymi liczbami węzłów (start, Kiwipete, przypadki bicia w przelocie,
+// roszady i promocji)
+struct PerftPosition
+{
+    const char *name;
+    const char *fen;
+    int depth;
+    uint64_t nodes;
+};
+
+const PerftPosition REFERENCE_POSITIONS[] = {
+        {"start",                   "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",                 5, 4865609},
+        {"kiwipete",                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",     4, 4085603},
+        {"position 3",              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",                                6, 11030083},
+        {"position 4",              "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",         5, 15833292},
+        {"position 5",              "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",                4, 2103487},
+        {"position 6",              "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+        {"illegal ep move #1",      "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1",                                        6, 1134888},
+        {"illegal ep move #2",      "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",                                       6, 1015133},
+        {"ep capture checks",       "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",                                      6, 1440467},
+        {"short castling check",    "5k2/8/8/8/8/8/8/4K2R w K - 0 1",                                           6, 661072},
+        {"long castling check",     "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",                                           6, 803711},
+        {"castle rights",           "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1",                                4, 1274206},
+        {"castling prevented",      "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1",                                 4, 1720476},
+        {"promote out of check",    "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1",                                        6, 3821001},
+        {"discovered check",        "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1",                                      5, 1004658},
+        {"promote to give check",   "4k3/1P6/8/8/8/8/K7/8 w - - 0 1",                                           6, 217342},
+        {"underpromote to check",   "8/P1k5/K7/8/8/8/8/8 w - - 0 1",                                            6, 92683},
+        {"self stalemate",          "K1k5/8/P7/8/8/8/8/8 w - - 0 1",                                            6, 2217},
+        {"stalemate and checkmate", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1",                                           7, 567584},
+        {"double check",            "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1",                                        4, 23527},
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Fragment drzewa dla jednego wątku: ruch z korzenia i (przy głębokości od 3) odpowiedź przeciwnika
+struct PerftTask
+{
+    int rootIndex;
+    PackedMove moves[2];
+    int plies;
+};
+
+struct PerftResult
+{
+    uint64_t nodes;
+    std::vector<uint64_t> rootNodes;   // Węzły pod każdym ruchem z korzenia
+    std::vector<uint64_t> threadNodes; // Węzły policzone przez każdy wątek
+};
+
+// Perft rozdzielony między wątki. Każdy wątek ma własną grę ustawioną z tego samego FEN i pobiera kolejne
+// zadania ze wspólnego licznika, więc wątki kończące wcześniej przejmują resztę pracy.
+PerftResult parallelPerft(std::vector<std::unique_ptr<ChessGame>> &games, const std::string &fen, int depth,
+                          MoveList &rootMoves, PerftTable *table)
+{
+    ChessGame &root = *games[0];
+    root.loadFen(fen);
+    rootMoves = root.getAllPossibleMoves(root.getCurrentPlayer());
+
+    // Podział na dwa półruchy daje kilkaset zadań zamiast kilkudziesięciu i równiejsze obciążenie wątków
+    int plies = depth >= 3 ? 2 : 1;
+    std::vector<PerftTask> tasks;
+    for (int i = 0; i < rootMoves.size(); ++i)
+    {
+        if (plies == 1)
+        {
+            tasks.push_back({i, {rootMoves[i], PackedMove()}, 1});
+            continue;
+        }
+        root.doMove(rootMoves[i]);
+        for (PackedMove reply: root.getAllPossibleMoves(root.getCurrentPlayer()))
+        {
+            tasks.push_back({i, {rootMoves[i], reply}, 2});
+        }
+        root.undoMove();
+    }
+
+    PerftResult result{0, std::vector<uint64_t>(rootMoves.size()), std::vector<uint64_t>(games.size())};
+    std::vector<uint64_t> taskNodes(tasks.size());
+    std::atomic<size_t> nextTask(0);
+    auto worker = [&](size_t threadIndex)
+    {
+        ChessGame &game = *games[threadIndex];
+        game.loadFen(fen);
+        uint64_t counted = 0;
+        for (size_t t = nextTask++; t < tasks.size(); t = nextTask++)
+        {
+            const PerftTask &task = tasks[t];
+            for (int ply = 0; ply < task.plies; ++ply)
+            {
+                game.doMove(task.moves[ply]);
+            }
+            taskNodes[t] = game.perft(depth - task.plies, table);
+            for (int ply = 0; ply < task.plies; ++ply)
+            {
+                game.undoMove();
+            }
+            counted += taskNodes[t];
+        }
+        result.threadNodes[threadIndex] = counted;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < games.size(); ++i)
+    {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &thread: threads)
+    {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < tasks.size(); ++t)
+    {
+        result.rootNodes[tasks[t].rootIndex] += taskNodes[t];
+        result.nodes += taskNodes[t];
+    }
+    return result;
+}
+
+void printThreadNodes(const std::vector<uint64_t> &threadNodes, double seconds)
+{
+    for (size_t i = 0; i < threadNodes.size(); ++i)
+    {
+        std::cout << "Thread " << i << ": " << threadNodes[i] << " nodes, "
+                  << static_cast<uint64_t>(threadNodes[i] / seconds) << " nodes/s" << std::endl;
+    }
+}
+
+// Bez argumentów: cały zestaw pozycji wzorcowych, kod wyjścia 1 przy niezgodności.
+// "perft <głębokość> [FEN]": liczba węzłów dla każdego ruchu z korzenia.
+// Opcje przed argumentami: "-t <wątki>" (domyślnie wszystkie rdzenie), "-H <MB>" tabela perft (domyślnie brak).
+int main(int argc, char *argv[])
+{
+    int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    int hashMB = 0;
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    {
+        if (std::strcmp(argv[arg], "-t") == 0)
+        {
+            threadCount = std::atoi(argv[arg + 1]);
+        }
+        else if (std::strcmp(argv[arg], "-H") == 0)
+        {
+            hashMB = std::atoi(argv[arg + 1]);
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (threadCount < 1 || hashMB < 0 || (arg < argc && argv[arg][0] == '-'))
+    {
+        std::cerr << "Usage: perft [-t threads] [-H hashMB] [depth [fen]]" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<ChessGame>> games;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        games.emplace_back(new ChessGame());
+    }
+    std::unique_ptr<PerftTable> table(hashMB > 0 ? new PerftTable(hashMB) : nullptr);
+    MoveList rootMoves;
+
+    if (arg < argc)
+    {
+        int depth = std::atoi(argv[arg]);
+        std::string fen = arg + 1 < argc ? argv[arg + 1] : REFERENCE_POSITIONS[0].fen;
+        for (int i = arg + 2; i < argc; ++i)
+        {
+            fen += std::string(" ") + argv[i];
+        }
+        if (depth < 1 || !games[0]->loadFen(fen))
+        {
+            std::cerr << "Usage: perft [-t threads] [-H hashMB] [depth [fen]]" << std::endl;
+            return 2;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        PerftResult result = parallelPerft(games, fen, depth, rootMoves, table.get());
+        double seconds = secondsSince(start);
+        for (int i = 0; i < rootMoves.size(); ++i)
+        {
+            std::cout << rootMoves[i].move.toString() << ": " << result.rootNodes[i] << "\n";
+        }
+        std::cout << "Nodes: " << result.nodes << "\n";
+        printThreadNodes(result.threadNodes, seconds);
+        std::cout << "Time: " << seconds << " s, " << static_cast<uint64_t>(result.nodes / seconds) << " nodes/s"
+                  << std::endl;
+        return 0;
+    }
+
+    bool allPassed = true;
+    uint64_t totalNodes = 0;
+    std::vector<uint64_t> threadNodes(threadCount);
+    auto suiteStart = std::chrono::steady_clock::now();
+    for (const PerftPosition &position: REFERENCE_POSITIONS)
+    {
+        auto start = std::chrono::steady_clock::now();
+        PerftResult result = parallelPerft(games, position.fen, position.depth, rootMoves, table.get());
+        double seconds = secondsSince(start);
+        totalNodes += result.nodes;
+        for (int i = 0; i < threadCount; ++i)
+        {
+            threadNodes[i] += result.threadNodes[i];
+        }
+
+        bool passed = result.nodes == position.nodes;
+        allPassed = allPassed && passed;
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << position.name << " depth " << position.depth << ": "
+                  << result.nodes;
+        if (!passed)
+        {
+            std::cout << " (expected " << position.nodes << ")";
+        }
+        std::cout << ", " << static_cast<uint64_t>(result.nodes / seconds) << " nodes/s" << std::endl;
+    }
+
+    double seconds = secondsSince(suiteStart);
+    printThreadNodes(threadNodes, seconds);
+    std::cout << "Total: " << totalNodes << " nodes in " << seconds << " s, " << threadCount << " threads, "
+              << static_cast<uint64_t>(totalNodes / seconds) << " nodes/s" << std::endl;
+    return allPassed ? 0 : 1;
+}